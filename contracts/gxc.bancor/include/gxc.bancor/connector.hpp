@@ -3,6 +3,9 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 #include <cmath>
+#include <optional>
+
+#include <gxclib/token_reader.hpp>
 
 using namespace eosio;
 using std::string;
@@ -14,61 +17,8 @@ constexpr name active_permission{"active"_n};
 struct token {
    static constexpr name token_account = "gxc.token"_n;
 
-   struct [[eosio::table("stat"), eosio::contract("gxc.token")]] currency_stats {
-      asset    supply;      // 16
-   private:
-      int64_t  max_supply_; // 24
-   public:
-      name     issuer;      // 32
-   private:
-      uint32_t opts_ = 0x7; // 36, defaults to (mintable, recallable, freezable)
-   public:
-      uint32_t withdraw_delay_sec = 24 * 3600; // 40, defaults to 1 day
-   private:
-      int64_t  withdraw_min_amount_; // 48
-
-   public:
-      enum opt {
-         mintable = 0,
-         recallable,
-         freezable,
-         pausable,
-         paused,
-         whitelistable,
-         whitelist_on
-      };
-
-      asset max_supply()const { return asset(max_supply_, supply.symbol); }
-      void max_supply(const asset& quantity) {
-         check(quantity.symbol == supply.symbol, "symbol mismatch");
-         max_supply_ = quantity.amount;
-      }
-
-      bool option(opt n)const { return (opts_ >> (0 + n)) & 0x1; }
-      void option(opt n, bool val) {
-         if (val) opts_ |= 0x1 << n;
-         else     opts_ &= ~(0x1 << n);
-      }
-
-      asset withdraw_min_amount()const { return asset(withdraw_min_amount_, supply.symbol); }
-      void withdraw_min_amount(const asset& quantity) {
-         check(quantity.symbol == supply.symbol, "symbol mismatch");
-         check(quantity.amount > 0, "withdraw_min_amount should be positive");
-         withdraw_min_amount_ = quantity.amount;
-      }
-
-      uint64_t primary_key()const { return supply.symbol.code().raw(); }
-
-      EOSLIB_SERIALIZE(currency_stats, (supply)(max_supply_)(issuer)(opts_)
-                                       (withdraw_delay_sec)(withdraw_min_amount_))
-   };
-
-   typedef eosio::multi_index< "stat"_n, currency_stats > stats;
-
    extended_asset get_supply( const symbol_code& sym_code ) {
-      stats statstable( token_account, contract.value );
-      const auto& st = statstable.get( sym_code.raw() );
-      return {st.supply, st.issuer};
+      return {gxc::token_reader::stat(contract, sym_code).supply(), contract};
    }
 
    token(name c, name auth = name()) {
@@ -83,6 +33,33 @@ struct token {
       action_wrapper<"transfer"_n, &token::transfer>(token_account, auths).send(from, to, value, memo);
    }
 
+   struct leg {
+      name           from;
+      name           to;
+      extended_asset value;
+      string         memo;
+
+      EOSLIB_SERIALIZE(leg, (from)(to)(value)(memo))
+   };
+
+   token& with(name auth) {
+      auths.emplace_back(permission_level(auth, active_permission));
+      return *this;
+   }
+
+   // applies all legs in a single action, `auths` should satisfy `settler` and every leg
+   void settle(name settler, const std::vector<leg>& legs) {
+      if (auths.empty())
+         auths.emplace_back(permission_level(contract, active_permission));
+      action_wrapper<"settle"_n, &token::settle>(token_account, auths).send(settler, legs);
+   }
+
+   // whether `owner` has approved `spender` at least `value` which never expires
+   static bool approved(name owner, name spender, const extended_asset& value) {
+      auto a = gxc::token_reader::allowance(owner, spender, value.contract, value.quantity.symbol.code());
+      return a && !a.expires() && a.quantity().amount >= value.quantity.amount;
+   }
+
    void approve(name owner, name spender, extended_asset value) {
       if (auths.empty())
          auths.emplace_back(permission_level(owner, active_permission));
@@ -110,18 +87,35 @@ struct reserve {
 
    operator bool() { return has_reserve(); }
 
-   bool has_reserve() {
-      reserves rsv(reserve_account, derivative.get_contract().value);
-      auto it = rsv.find(derivative.get_symbol().code().raw());
-      return it != rsv.end();
-   }
+   bool has_reserve() { return get_row() != nullptr; }
 
    double get_rate() {
-      reserves rsv(reserve_account, derivative.get_contract().value);
-      auto it = rsv.find(derivative.get_symbol().code().raw());
-      if (it != rsv.end())
-         return it->rate;
-      return 0.;
+      auto row = get_row();
+      return row ? row->rate : 0.;
+   }
+
+   asset get_underlying() {
+      auto row = get_row();
+      check(row != nullptr, "reserve not found");
+      return row->underlying;
+   }
+
+   /**
+    * Returns reserve rate if it is higher than the price given by bancor curve,
+    * that is, the conversion should be done by reserve rate as a price floor.
+    *
+    * @param connected - amount of connected token
+    * @param smart - amount of smart token
+    */
+   std::optional<double> quote(const asset& connected, const asset& smart) {
+      auto row = get_row();
+      if (!row) return {};
+
+      double unit_price = connected.amount * pow(10, smart.symbol.precision())
+                        / double(smart.amount) / pow(10, connected.symbol.precision());
+      if (row->rate > unit_price)
+         return row->rate;
+      return {};
    }
 
    reserve(extended_symbol d, name auth = name()) {
@@ -138,6 +132,22 @@ struct reserve {
 
    extended_symbol derivative;
    std::vector<permission_level> auths;
+
+private:
+   // loads reserve row at the first access, and reuses it afterwards
+   const currency_reserves* get_row() {
+      if (!loaded) {
+         reserves rsv(reserve_account, derivative.get_contract().value);
+         auto it = rsv.find(derivative.get_symbol().code().raw());
+         if (it != rsv.end())
+            row = *it;
+         loaded = true;
+      }
+      return row ? &*row : nullptr;
+   }
+
+   bool loaded = false;
+   std::optional<currency_reserves> row;
 };
 
 struct connector {
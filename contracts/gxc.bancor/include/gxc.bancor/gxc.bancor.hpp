@@ -67,6 +67,9 @@ public:
    [[eosio::action]]
    void convert(name sender, extended_asset from, extended_asset to);
 
+   [[eosio::action]]
+   void quote(extended_asset from, extended_asset to);
+
    [[eosio::action]]
    void init(name owner, extended_symbol connected);
 
@@ -80,7 +83,19 @@ public:
    void setowner(name owner);
 
 private:
+   struct conversion {
+      bool           buy = false;
+      bool           exact = false;       // amount of `to` is given, instead of amount of `from`
+      extended_asset paid;                // paid by sender
+      extended_asset received;            // received by sender
+      extended_asset fee;                 // included in `paid` on buying, excluded from `received` on selling
+      bool           claim_reserve = false; // sold smart token is claimed from reserve instead of being retired
+   };
+
    extended_asset get_fee(const extended_asset& value, const extended_asset& smart, const config& c, bool required = false);
+
+   conversion evaluate(connector& c, extended_asset from, extended_asset to, const config& cfg);
+   void settle(name sender, const conversion& r, const config& cfg);
 };
 
 } /// namespace gxc
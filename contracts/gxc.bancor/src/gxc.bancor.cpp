@@ -5,6 +5,10 @@ namespace gxc {
 
 constexpr name null_account = "gxc.null"_n;
 
+inline std::string to_string(const extended_asset& value) {
+   return value.quantity.to_string() + "@" + value.contract.to_string();
+}
+
 extended_asset bancor_contract::get_fee(const extended_asset& value, const extended_asset& smart, const config& c, bool required) {
    extended_asset fee = { 0, value.get_extended_symbol() };
    bool exempted = true;
@@ -32,191 +36,222 @@ extended_asset bancor_contract::get_fee(const extended_asset& value, const exten
    return fee;
 }
 
-void bancor_contract::convert(name sender, extended_asset from, extended_asset to) {
-   require_auth(sender);
+bancor_contract::conversion bancor_contract::evaluate(connector& c, extended_asset from, extended_asset to, const config& cfg) {
+   conversion r;
+   r.buy = from.get_extended_symbol() == cfg.get_connected_symbol();
+   r.exact = to.quantity.amount > 0;
 
-   check((from.quantity.amount > 0) ^ (to.quantity.amount > 0), "Either `from` or `to` should be positive");
+   if (r.buy) {
+      if (to.quantity.amount == 0) {
+         auto fee = get_fee(from, to, cfg);
 
-   configuration cfg(_self, _self.value);
-   check(cfg.exists(), "contract not initialized");
+         auto quant_after_fee = from - fee;
+         check(quant_after_fee.quantity.amount > 0, "paid token not enough after charging fee");
+
+         auto smart_issued = c.convert_to_smart(quant_after_fee, to.get_extended_symbol());
+         check(smart_issued.value.quantity.amount > 0, "paid token not enough for conversion");
+
+         auto rsv = reserve(to.get_extended_symbol());
+         if (auto reserve_rate = rsv.quote(smart_issued.delta, smart_issued.value.quantity)) {
+            double rate = *reserve_rate;
+            c.balance -= smart_issued.delta;
+
+            double dS = quant_after_fee.quantity.amount / rate / pow(10, from.quantity.symbol.precision() - to.quantity.symbol.precision());
+            if (dS < 0) dS = 0;
 
-   if (from.get_extended_symbol() == cfg.get().get_connected_symbol()) {
-      // initialize connector or buy smart
-      connectors conn(_self, to.contract.value);
-      auto it = conn.find(to.quantity.symbol.code().raw());
-      check(it != conn.end(), "connector not exists");
-
-      conn.modify(it, same_payer, [&](auto& c) {
-         if (to.quantity.amount == 0) {
-            auto fee = get_fee(from, to, cfg.get());
-
-            auto quant_after_fee = from - fee;
-            check(quant_after_fee.quantity.amount > 0, "paid token not enough after charging fee");
-
-            auto smart_issued = c.convert_to_smart(quant_after_fee, to.get_extended_symbol());
-            check(smart_issued.value.quantity.amount > 0, "paid token not enough for conversion");
-
-            auto rsv = reserve(to.get_extended_symbol());
-            if (rsv) {
-               double unit_price = smart_issued.delta.amount * pow(10, smart_issued.value.quantity.symbol.precision())
-                                 / double(smart_issued.value.quantity.amount) / pow(10, smart_issued.delta.symbol.precision());
-               double rate = rsv.get_rate();
-               if (rate > unit_price) {
-                  c.balance -= smart_issued.delta;
-
-                  double dS = quant_after_fee.quantity.amount / rate / pow(10, from.quantity.symbol.precision() - to.quantity.symbol.precision());
-                  if (dS < 0) dS = 0;
-
-                  auto conversion_rate = ((int64_t)dS) / dS;
-                  smart_issued.value.quantity.amount = int64_t(dS);
-                  smart_issued.delta.amount = quant_after_fee.quantity.amount - int64_t(quant_after_fee.quantity.amount * (1 - conversion_rate));
-                  smart_issued.ratio = conversion_rate;
-
-                  c.balance += smart_issued.delta;
-               }
-            }
-
-            if ((quant_after_fee.quantity - smart_issued.delta).amount > 0) {
-               auto overcharged = int64_t(fee.quantity.amount * (1 - smart_issued.ratio));
-               if (overcharged < 0) overcharged = 0;
-               fee.quantity.amount -= overcharged;
-            }
-            auto sum = extended_asset{smart_issued.delta, quant_after_fee.contract} + fee;
-
-            token(from.contract, _self).transfer(sender, _self, sum, "bancor conversion");
-            if (fee.quantity.amount > 0) {
-               token(from.contract, _self).transfer(_self, cfg.get().owner, fee, "conversion fee");
-            }
-            token(to.contract).transfer(null_account, smart_issued.value.contract, smart_issued.value);
-            token(to.contract).transfer(smart_issued.value.contract, sender, smart_issued.value);
-            dlog("effective_price = ", asset(smart_issued.delta.amount * pow(10, smart_issued.value.quantity.symbol.precision()) / smart_issued.value.quantity.amount, from.quantity.symbol));
-         } else {
-            auto connected_required = c.convert_to_exact_smart(from.get_extended_symbol(), to);
-
-            auto rsv = reserve(to.get_extended_symbol());
-            if (rsv) {
-               double unit_price = connected_required.delta.amount * pow(10, to.quantity.symbol.precision())
-                                 / double(to.quantity.amount) / pow(10, connected_required.delta.symbol.precision());
-               double rate = rsv.get_rate();
-               if (rate > unit_price) {
-                  c.balance -= connected_required.delta;
-
-                  double dC = to.quantity.amount * rate / pow(10, to.quantity.symbol.precision() - from.quantity.symbol.precision());
-                  if (dC < 0) dC = 0;
-
-                  auto conversion_rate = ((int64_t)dC) / dC;
-                  connected_required.value.quantity.amount = int64_t(dC);
-                  connected_required.delta.amount = int64_t(dC);
-                  connected_required.ratio = conversion_rate;
-
-                  c.balance += connected_required.delta;
-               }
-            }
-
-            auto fee = get_fee({connected_required.delta, connected_required.value.contract}, to, cfg.get(), true);
-
-            token(from.contract, _self).transfer(sender, _self, extended_asset{connected_required.delta, from.contract} + fee, "bancor conversion");
-            token(to.contract).transfer(null_account, to.contract, to);
-            token(to.contract).transfer(to.contract, sender, to);
-            if (fee.quantity.amount > 0) {
-               token(from.contract, _self).transfer(_self, cfg.get().owner, fee, "conversion fee");
-            }
-            dlog("effective_price = ", asset(connected_required.delta.amount * pow(10, to.quantity.symbol.precision()) / to.quantity.amount, from.quantity.symbol));
+            auto conversion_rate = ((int64_t)dS) / dS;
+            smart_issued.value.quantity.amount = int64_t(dS);
+            smart_issued.delta.amount = quant_after_fee.quantity.amount - int64_t(quant_after_fee.quantity.amount * (1 - conversion_rate));
+            smart_issued.ratio = conversion_rate;
+
+            c.balance += smart_issued.delta;
          }
-      });
+
+         if ((quant_after_fee.quantity - smart_issued.delta).amount > 0) {
+            auto overcharged = int64_t(fee.quantity.amount * (1 - smart_issued.ratio));
+            if (overcharged < 0) overcharged = 0;
+            fee.quantity.amount -= overcharged;
+         }
+
+         r.paid     = extended_asset{smart_issued.delta, quant_after_fee.contract} + fee;
+         r.received = smart_issued.value;
+         r.fee      = fee;
+         dlog("effective_price = ", asset(smart_issued.delta.amount * pow(10, smart_issued.value.quantity.symbol.precision()) / smart_issued.value.quantity.amount, from.quantity.symbol));
+      } else {
+         auto connected_required = c.convert_to_exact_smart(from.get_extended_symbol(), to);
+
+         auto rsv = reserve(to.get_extended_symbol());
+         if (auto reserve_rate = rsv.quote(connected_required.delta, to.quantity)) {
+            double rate = *reserve_rate;
+            c.balance -= connected_required.delta;
+
+            double dC = to.quantity.amount * rate / pow(10, to.quantity.symbol.precision() - from.quantity.symbol.precision());
+            if (dC < 0) dC = 0;
+
+            auto conversion_rate = ((int64_t)dC) / dC;
+            connected_required.value.quantity.amount = int64_t(dC);
+            connected_required.delta.amount = int64_t(dC);
+            connected_required.ratio = conversion_rate;
+
+            c.balance += connected_required.delta;
+         }
+
+         auto fee = get_fee({connected_required.delta, connected_required.value.contract}, to, cfg, true);
+
+         r.paid     = extended_asset{connected_required.delta, from.contract} + fee;
+         r.received = to;
+         r.fee      = fee;
+         dlog("effective_price = ", asset(connected_required.delta.amount * pow(10, to.quantity.symbol.precision()) / to.quantity.amount, from.quantity.symbol));
+      }
    } else {
-      // sell smart
-      connectors conn(_self, from.contract.value);
-      auto it = conn.find(from.quantity.symbol.code().raw());
-      check(it != conn.end(), "connector not exists");
-
-      conn.modify(it, same_payer, [&](auto& c) {
-         if (to.quantity.amount == 0) {
-            auto connected_out = c.convert_from_smart(from, cfg.get().get_connected_symbol());
-
-            bool need_burn = false;
-            auto rsv = reserve(from.get_extended_symbol());
-            if (rsv) {
-               double unit_price = connected_out.delta.amount * pow(10, from.quantity.symbol.precision())
-                                 / double(from.quantity.amount) / pow(10, connected_out.delta.symbol.precision());
-               double rate = rsv.get_rate();
-               if (rate > unit_price) {
-                  c.balance += connected_out.delta;
-
-                  double dC = from.quantity.amount * rate / pow(10, from.quantity.symbol.precision() - to.quantity.symbol.precision());
-                  if (dC < 0) dC = 0;
-
-                  auto conversion_rate = ((int64_t)dC) / dC;
-                  connected_out.value.quantity.amount = int64_t(dC);
-                  connected_out.delta.amount = int64_t(dC);
-                  connected_out.ratio = conversion_rate;
-
-                  need_burn = true;
-               }
-            }
-
-            auto fee = get_fee(connected_out.value, from, cfg.get());
-
-            auto quant_after_fee = connected_out.value - fee;
-            check(quant_after_fee.quantity.amount > 0, "paid token not enough after charging fee");
-
-            auto refund = extended_asset{int64_t(from.quantity.amount * (1 - connected_out.ratio)), from.get_extended_symbol()};
-            token(from.contract, _self).transfer(sender, _self, from - refund);
-            if (!need_burn) {
-               token(from.contract, _self).transfer(_self, null_account, from - refund);
-            } else {
-               token(from.contract, _self).approve(_self, reserve::reserve_account, from - refund);
-               rsv.claim(_self, from - refund);
-            }
-            token(cfg.get().connected_contract, _self).transfer(_self, sender, quant_after_fee);
-            if (fee.quantity.amount > 0) {
-               token(cfg.get().connected_contract, _self).transfer(_self, cfg.get().owner, fee, "conversion fee");
-            }
-            dlog("effective_price = ", asset(connected_out.delta.amount * pow(10, from.quantity.symbol.precision()) / (from.quantity.amount - refund.quantity.amount), connected_out.value.quantity.symbol));
-         } else {
-            auto fee = get_fee(to, from, cfg.get(), true);
-            auto smart_required = c.convert_exact_from_smart(from.get_extended_symbol(), to + fee);
-
-            bool need_burn = false;
-            auto rsv = reserve(from.get_extended_symbol());
-            if (rsv) {
-               double unit_price = smart_required.delta.amount * pow(10, smart_required.value.quantity.symbol.precision())
-                                 / double(smart_required.value.quantity.amount) / pow(10, smart_required.delta.symbol.precision());
-               double rate = rsv.get_rate();
-               if (rate > unit_price) {
-                  c.balance += smart_required.delta;
-
-                  double dS = to.quantity.amount / rate / pow(10, to.quantity.symbol.precision() - from.quantity.symbol.precision());
-                  if (dS < 0) dS = 0;
-
-                  auto conversion_rate = ((int64_t)dS) / dS;
-                  smart_required.value.quantity.amount = int64_t(dS);
-                  smart_required.delta.amount = to.quantity.amount - int64_t(to.quantity.amount * (1 - conversion_rate));
-                  smart_required.ratio = conversion_rate;
-
-                  need_burn = true;
-               }
-            }
-
-            to.quantity = smart_required.delta - fee.quantity;
-
-            token(from.contract, _self).transfer(sender, _self, smart_required.value);
-            if (!need_burn) {
-               token(from.contract, _self).transfer(_self, null_account, smart_required.value);
-            } else {
-               token(from.contract, _self).approve(_self, reserve::reserve_account, smart_required.value);
-               rsv.claim(_self, smart_required.value);
-            }
-            token(to.contract, _self).transfer(_self, sender, to);
-            if (fee.quantity.amount > 0) {
-               token(to.contract, _self).transfer(_self, cfg.get().owner, fee, "conversion fee");
-            }
-            dlog("effective_price = ", asset(smart_required.delta.amount * pow(10, from.quantity.symbol.precision()) / (smart_required.value.quantity.amount), to.quantity.symbol));
+      if (to.quantity.amount == 0) {
+         auto connected_out = c.convert_from_smart(from, cfg.get_connected_symbol());
+
+         auto rsv = reserve(from.get_extended_symbol());
+         if (auto reserve_rate = rsv.quote(connected_out.delta, from.quantity)) {
+            double rate = *reserve_rate;
+            c.balance += connected_out.delta;
+
+            double dC = from.quantity.amount * rate / pow(10, from.quantity.symbol.precision() - to.quantity.symbol.precision());
+            if (dC < 0) dC = 0;
+
+            auto conversion_rate = ((int64_t)dC) / dC;
+            connected_out.value.quantity.amount = int64_t(dC);
+            connected_out.delta.amount = int64_t(dC);
+            connected_out.ratio = conversion_rate;
+
+            r.claim_reserve = true;
+         }
+
+         auto fee = get_fee(connected_out.value, from, cfg);
+
+         auto quant_after_fee = connected_out.value - fee;
+         check(quant_after_fee.quantity.amount > 0, "paid token not enough after charging fee");
+
+         auto refund = extended_asset{int64_t(from.quantity.amount * (1 - connected_out.ratio)), from.get_extended_symbol()};
+
+         r.paid     = from - refund;
+         r.received = quant_after_fee;
+         r.fee      = fee;
+         dlog("effective_price = ", asset(connected_out.delta.amount * pow(10, from.quantity.symbol.precision()) / (from.quantity.amount - refund.quantity.amount), connected_out.value.quantity.symbol));
+      } else {
+         auto fee = get_fee(to, from, cfg, true);
+         auto smart_required = c.convert_exact_from_smart(from.get_extended_symbol(), to + fee);
+
+         auto rsv = reserve(from.get_extended_symbol());
+         if (auto reserve_rate = rsv.quote(smart_required.delta, smart_required.value.quantity)) {
+            double rate = *reserve_rate;
+            c.balance += smart_required.delta;
+
+            double dS = to.quantity.amount / rate / pow(10, to.quantity.symbol.precision() - from.quantity.symbol.precision());
+            if (dS < 0) dS = 0;
+
+            auto conversion_rate = ((int64_t)dS) / dS;
+            smart_required.value.quantity.amount = int64_t(dS);
+            smart_required.delta.amount = to.quantity.amount - int64_t(to.quantity.amount * (1 - conversion_rate));
+            smart_required.ratio = conversion_rate;
+
+            r.claim_reserve = true;
          }
+
+         to.quantity = smart_required.delta - fee.quantity;
+
+         r.paid     = smart_required.value;
+         r.received = to;
+         r.fee      = fee;
+         dlog("effective_price = ", asset(smart_required.delta.amount * pow(10, from.quantity.symbol.precision()) / (smart_required.value.quantity.amount), to.quantity.symbol));
+      }
+   }
+
+   return r;
+}
+
+void bancor_contract::settle(name sender, const conversion& r, const config& cfg) {
+   // legs are grouped by the authority they need, so that no leg is validated with more authority than before
+   if (r.buy) {
+      std::vector<token::leg> legs = {{sender, _self, r.paid, "bancor conversion"}};
+      // fee is paid before issuing smart token, or after it when buying exact amount
+      if (!r.exact && r.fee.quantity.amount > 0) {
+         legs.push_back({_self, cfg.owner, r.fee, "conversion fee"});
+      }
+      token(r.paid.contract, _self).settle(_self, legs);
+
+      // smart token is issued by its issuer, and this contract takes part only as settler
+      token(r.received.contract, _self).with(r.received.contract).settle(_self, {
+         {null_account, r.received.contract, r.received, ""},
+         {r.received.contract, sender, r.received, ""}
       });
+      if (r.exact && r.fee.quantity.amount > 0) {
+         token(r.paid.contract, _self).transfer(_self, cfg.owner, r.fee, "conversion fee");
+      }
+   } else {
+      std::vector<token::leg> legs = {{sender, _self, r.paid, ""}};
+      if (!r.claim_reserve) {
+         legs.push_back({_self, null_account, r.paid, ""});
+      } else {
+         // reserve claim should be done between receiving smart token and paying connected token,
+         // and takes smart token on allowance of the claimed amount, unless a large enough one is left
+         token(r.paid.contract, _self).settle(_self, legs);
+         if (!token::approved(_self, reserve::reserve_account, r.paid))
+            token(r.paid.contract, _self).approve(_self, reserve::reserve_account, r.paid);
+         reserve(r.paid.get_extended_symbol()).claim(_self, r.paid);
+         legs.clear();
+      }
+      legs.push_back({_self, sender, r.received, ""});
+      if (r.fee.quantity.amount > 0) {
+         legs.push_back({_self, cfg.owner, r.fee, "conversion fee"});
+      }
+      token(r.received.contract, _self).settle(_self, legs);
    }
 }
 
+void bancor_contract::convert(name sender, extended_asset from, extended_asset to) {
+   require_auth(sender);
+
+   check((from.quantity.amount > 0) ^ (to.quantity.amount > 0), "Either `from` or `to` should be positive");
+
+   configuration cfg(_self, _self.value);
+   check(cfg.exists(), "contract not initialized");
+   auto c = cfg.get();
+
+   // connector is identified by smart token, which is `to` on buying and `from` on selling
+   auto smart = (from.get_extended_symbol() == c.get_connected_symbol()) ? to.get_extended_symbol() : from.get_extended_symbol();
+
+   connectors conn(_self, smart.get_contract().value);
+   auto it = conn.find(smart.get_symbol().code().raw());
+   check(it != conn.end(), "connector not exists");
+
+   conversion r;
+   conn.modify(it, same_payer, [&](auto& row) {
+      r = evaluate(row, from, to, c);
+   });
+
+   settle(sender, r, c);
+}
+
+void bancor_contract::quote(extended_asset from, extended_asset to) {
+   check((from.quantity.amount > 0) ^ (to.quantity.amount > 0), "Either `from` or `to` should be positive");
+
+   configuration cfg(_self, _self.value);
+   check(cfg.exists(), "contract not initialized");
+   auto c = cfg.get();
+
+   auto smart = (from.get_extended_symbol() == c.get_connected_symbol()) ? to.get_extended_symbol() : from.get_extended_symbol();
+
+   connectors conn(_self, smart.get_contract().value);
+   auto it = conn.find(smart.get_symbol().code().raw());
+   check(it != conn.end(), "connector not exists");
+
+   // evaluate on a copy, connector is not changed
+   auto row = *it;
+   auto r = evaluate(row, from, to, c);
+
+   // This action never succeeds, the result is delivered through the error message.
+   check(false, "quote:{\"paid\":\"" + to_string(r.paid) +
+                "\",\"received\":\"" + to_string(r.received) +
+                "\",\"fee\":\"" + to_string(r.fee) + "\"}");
+}
+
 void bancor_contract::init(name owner, extended_symbol connected) {
    require_auth(_self);
 
@@ -1,8 +1,12 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
+#include <eosio/binary_extension.hpp>
 #include <eoslib/crypto.hpp>
 #include <eoslib/symbol.hpp>
 
+#include <optional>
+#include <string_view>
+
 using namespace eosio;
 using std::string;
 
@@ -18,11 +22,42 @@ public:
       extended_asset value;
       checksum256 hashlock;
       time_point_sec timelock;
+      binary_extension<uint64_t> id; // absent in contracts keyed by legacy hash
+      binary_extension<uint64_t> expiry_id; // absent in contracts created before the expiry queue
+
+      static uint64_t hash(std::string_view s) { return xxh64(s.data(), s.size()); }
+
+      /**
+       * Encodes `s` as eosio name if it is a valid name which converts back to the same string.
+       */
+      static std::optional<uint64_t> name_key(std::string_view s) {
+         if (s.size() > 13 || (s.size() && s.back() == '.')) return {};
+
+         uint64_t value = 0;
+         for (size_t i = 0; i < s.size(); ++i) {
+            char c = s[i];
+            uint64_t v;
+            if (c >= 'a' && c <= 'z')      v = (c - 'a') + 6;
+            else if (c >= '1' && c <= '5') v = (c - '1') + 1;
+            else if (c == '.')             v = 0;
+            else return {};
+
+            if (i < 12) value |= v << (64 - 5 * (i + 1));
+            else if (v > 0x0f) return {};
+            else value |= v;
+         }
+         return value;
+      }
+
+      // short names are encoded directly, and only long names are hashed
+      static uint64_t key(std::string_view s) {
+         auto k = name_key(s);
+         return k ? *k : hash(s);
+      }
 
-      static uint64_t hash(string s) { return xxh64(s.data(), s.size()); }
-      uint64_t primary_key()const { return htlc::hash(contract_name); }
+      uint64_t primary_key()const { return id.has_value() ? id.value() : htlc::hash(contract_name); }
 
-      EOSLIB_SERIALIZE(htlc, (contract_name)(recipient)(value)(hashlock)(timelock))
+      EOSLIB_SERIALIZE(htlc, (contract_name)(recipient)(value)(hashlock)(timelock)(id)(expiry_id))
    };
 
    struct [[eosio::table]] config {
@@ -30,16 +65,33 @@ public:
       uint32_t min_duration;
 
       static uint64_t hash(extended_asset value) {
-         auto sym_code = extended_symbol_code(value.quantity.symbol.code(), value.contract);
-         return xxh64(reinterpret_cast<const char*>(&sym_code), sizeof(uint128_t));
+         auto sym_code = extended_symbol_code(value.quantity.symbol.code(), value.contract).raw();
+         return xxh64_128(static_cast<uint64_t>(sym_code), static_cast<uint64_t>(sym_code >> 64));
       }
       uint64_t primary_key()const { return config::hash(min_amount); }
 
       EOSLIB_SERIALIZE(config, (min_amount)(min_duration));
    };
 
+   // global queue of contracts ordered by timelock, in scope of `_self`
+   // entries are keyed by sequential id, which is kept in `htlc::expiry_id` of the contract
+   struct [[eosio::table]] expiry {
+      uint64_t id;
+      name owner;
+      uint64_t key;
+      time_point_sec timelock;
+
+      uint64_t primary_key()const { return id; }
+      uint64_t by_timelock()const { return timelock.sec_since_epoch(); }
+
+      EOSLIB_SERIALIZE(expiry, (id)(owner)(key)(timelock))
+   };
+
    typedef multi_index<"htlc"_n, htlc> htlcs;
    typedef multi_index<"config"_n, config> configs;
+   typedef multi_index<"expiry"_n, expiry,
+              indexed_by<"timelock"_n, const_mem_fun<expiry, uint64_t, &expiry::by_timelock>>
+           > expiries;
 
    void transfer(name from, name to, extended_asset value, string memo) {}
    typedef action_wrapper<"transfer"_n, &htlc_contract::transfer> transfer_action;
@@ -53,8 +105,17 @@ public:
    [[eosio::action]]
    void refund(name owner, string contract_name);
 
+   [[eosio::action]]
+   void sweep(uint32_t max_rows);
+
    [[eosio::action]]
    void setconfig(extended_asset min_amount, uint32_t min_duration);
+
+private:
+   htlcs::const_iterator find_contract(const htlcs& idx, const string& contract_name);
+   void _refund(name owner, const htlc& lck);
+   bool _refundable(name owner, const extended_asset& value);
+   void _dequeue(const htlc& lck);
 };
 
 }
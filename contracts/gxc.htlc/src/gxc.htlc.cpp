@@ -4,16 +4,22 @@
 #include <eosio/transaction.hpp>
 #include <eosio/crypto.hpp>
 #include <eoslib/hex.hpp>
+#include <gxclib/options.hpp>
+#include <gxclib/token_reader.hpp>
 
 namespace gxc {
 
 constexpr auto vault_account = "gxc.vault"_n.value;
+constexpr uint32_t sweep_retry_sec = 24 * 3600;
 
 void htlc_contract::newcontract(name owner, string contract_name, std::variant<name, checksum160> recipient, extended_asset value, checksum256 hashlock, time_point_sec timelock) {
    require_auth(owner);
 
    htlcs idx(_self, owner.value);
-   check(idx.find(htlc::hash(contract_name)) == idx.end(), "existing contract name");
+   check(find_contract(idx, contract_name) == idx.end(), "existing contract name");
+
+   auto key = htlc::key(contract_name);
+   check(idx.find(key) == idx.end(), "contract name collides with existing contract");
 
    configs cfg(_self, _self.value);
    auto it = cfg.find(config::hash(value));
@@ -26,12 +32,23 @@ void htlc_contract::newcontract(name owner, string contract_name, std::variant<n
    check(value >= min_amount, "specified amount is not enough");
    check(timelock >= current_time_point() + microseconds(static_cast<int64_t>(min_duration * 1000)), "the expiration time should be in the future");
 
+   expiries exp(_self, _self.value);
+   auto expiry_id = exp.available_primary_key();
+   exp.emplace(owner, [&](auto& e) {
+      e.id = expiry_id;
+      e.owner = owner;
+      e.key = key;
+      e.timelock = timelock;
+   });
+
    idx.emplace(owner, [&](auto& lck) {
       lck.contract_name = contract_name;
       lck.recipient = recipient;
       lck.value = value;
       lck.hashlock = hashlock;
       lck.timelock = timelock;
+      lck.id = key;
+      lck.expiry_id = expiry_id;
    });
 
    transfer_action("gxc.token"_n, {{_self, "active"_n}}).send(owner, _self, value, "CREATED BY " + owner.to_string() + (contract_name.size() ? ", " : "") + contract_name);
@@ -39,7 +56,9 @@ void htlc_contract::newcontract(name owner, string contract_name, std::variant<n
 
 void htlc_contract::withdraw(name owner, string contract_name, checksum256 preimage) {
    htlcs idx(_self, owner.value);
-   const auto& it = idx.get(htlc::hash(contract_name));
+   auto lck = find_contract(idx, contract_name);
+   check(lck != idx.end(), "contract not found");
+   const auto& it = *lck;
    check(it.timelock >= current_time_point(), "contract is expired");
 
    // `preimage` works as a key here.
@@ -54,6 +73,7 @@ void htlc_contract::withdraw(name owner, string contract_name, checksum256 preim
    else
       transfer_action("gxc.token"_n, {{_self, "active"_n}}).send(_self, "gxc.vault"_n, it.value, "FROM " + owner.to_string() + (contract_name.size() ? ", " : "") + contract_name);
 
+   _dequeue(it);
    idx.erase(it);
 }
 
@@ -61,19 +81,102 @@ void htlc_contract::refund(name owner, string contract_name) {
    require_auth(owner);
 
    htlcs idx(_self, owner.value);
-   const auto& it = idx.get(htlc::hash(contract_name));
+   auto lck = find_contract(idx, contract_name);
+   check(lck != idx.end(), "contract not found");
+   const auto& it = *lck;
 
    check(it.timelock < current_time_point(), "contract not expired");
 
-   if (std::holds_alternative<name>(it.recipient)) {
-      transfer_action("gxc.token"_n, {{_self, "active"_n}}).send(_self, owner, it.value, "REFUNDED FROM " + std::get<name>(it.recipient).to_string() + (contract_name.size() ? ", " : "") + contract_name);
+   _refund(owner, it);
+   _dequeue(it);
+   idx.erase(it);
+}
+
+void htlc_contract::sweep(uint32_t max_rows) {
+   check(max_rows > 0, "max_rows should be positive");
+
+   expiries exp(_self, _self.value);
+   auto tidx = exp.get_index<"timelock"_n>();
+   auto now = current_time_point();
+
+   for (auto it = tidx.begin(); it != tidx.end() && max_rows > 0 && it->timelock < now; --max_rows) {
+      htlcs idx(_self, it->owner.value);
+      auto lck = idx.find(it->key);
+
+      // a queued contract is always removed together with its entry, but skip safely if not
+      if (lck == idx.end()) {
+         it = tidx.erase(it);
+      } else if (_refundable(it->owner, lck->value)) {
+         _refund(it->owner, *lck);
+         idx.erase(lck);
+         it = tidx.erase(it);
+      } else {
+         // a failing refund reverts the whole sweep, so it is retried later unless the owner refunds it first
+         auto next = std::next(it);
+         tidx.modify(it, same_payer, [&](auto& e) {
+            e.timelock = time_point_sec(now) + sweep_retry_sec;
+         });
+         it = next;
+      }
+   }
+}
+
+htlc_contract::htlcs::const_iterator htlc_contract::find_contract(const htlcs& idx, const string& contract_name) {
+   auto name_key = htlc::name_key(contract_name);
+
+   auto it = idx.find(name_key ? *name_key : htlc::hash(contract_name));
+   if (it != idx.end() && it->contract_name == contract_name)
+      return it;
+
+   // contracts created before name encoding are keyed by hash of the name
+   if (name_key) {
+      it = idx.find(htlc::hash(contract_name));
+      if (it != idx.end() && it->contract_name == contract_name)
+         return it;
+   }
+   return idx.end();
+}
+
+void htlc_contract::_refund(name owner, const htlc& lck) {
+   const auto& contract_name = lck.contract_name;
+
+   if (std::holds_alternative<name>(lck.recipient)) {
+      transfer_action("gxc.token"_n, {{_self, "active"_n}}).send(_self, owner, lck.value, "REFUNDED FROM " + std::get<name>(lck.recipient).to_string() + (contract_name.size() ? ", " : "") + contract_name);
    } else {
-      auto bytes = std::get<checksum160>(it.recipient).extract_as_byte_array();
+      auto bytes = std::get<checksum160>(lck.recipient).extract_as_byte_array();
       auto str_recipient = to_hex(reinterpret_cast<const char*>(bytes.data()), bytes.size());
-      transfer_action("gxc.token"_n, {{_self, "active"_n}}).send(_self, owner, it.value, "REFUNDED FROM " + str_recipient + (contract_name.size() ? ", " : "") + contract_name);
+      transfer_action("gxc.token"_n, {{_self, "active"_n}}).send(_self, owner, lck.value, "REFUNDED FROM " + str_recipient + (contract_name.size() ? ", " : "") + contract_name);
+   }
+}
+
+// whether transfer of `_refund` passes the checks of gxc.token, which can be paused, frozen or whitelisted
+bool htlc_contract::_refundable(name owner, const extended_asset& value) {
+   auto sym_code = value.quantity.symbol.code();
+   auto st = token_reader::stat(value.contract, sym_code);
+   if (!st || st.option(token_options::paused)) return false;
+
+   bool whitelist_on = st.option(token_options::whitelist_on);
+   for (auto holder : {_self, owner}) {
+      auto acc = token_reader::account(holder, value.contract, sym_code);
+      if (!acc) {
+         // balance of the owner is opened by transfer, unless it should be opened manually
+         if (holder == _self || whitelist_on) return false;
+         continue;
+      }
+      if (acc.option(account_options::frozen)) return false;
+      if (whitelist_on && !acc.option(account_options::whitelist)) return false;
    }
+   return true;
+}
 
-   idx.erase(it);
+// contracts created before the queue was introduced have no entry
+void htlc_contract::_dequeue(const htlc& lck) {
+   if (!lck.expiry_id.has_value()) return;
+
+   expiries exp(_self, _self.value);
+   auto it = exp.find(lck.expiry_id.value());
+   if (it != exp.end())
+      exp.erase(it);
 }
 
 void htlc_contract::setconfig(extended_asset min_amount, uint32_t min_duration) {
@@ -3,6 +3,7 @@
  * @copyright defined in gxc/LICENSE
  */
 #include <gxc.reserve/gxc.reserve.hpp>
+#include <gxclib/options.hpp>
 #include <gxclib/token.hpp>
 
 using token = gxc::token_contract_mock;
@@ -13,16 +14,10 @@ void reserve::mint(extended_asset derivative, extended_asset underlying, std::ve
    require_vauth(derivative.contract);
    require_gauth(derivative.contract);
 
-   std::vector<std::string> valid_opts = {
-      "withdraw_min_amount",
-      "withdraw_delay_sec"
-   };
-   auto option_is_valid = [&](const std::string& key) -> bool {
-      return std::find(valid_opts.begin(), valid_opts.end(), key) != valid_opts.end();
-   };
-
-   for (auto o : opts) {
-      check(option_is_valid(o.first), "not allowed to set option `" + o.first + "`"); 
+   for (const auto& o : opts) {
+      auto def = token_options::registry.find(o.first);
+      if (!def || !(def->flags & token_options::reserve))
+         check(false, "not allowed to set option `" + o.first + "`");
    }
 
    check(underlying.contract == name("gxc"), "underlying asset should be system token");
@@ -43,7 +38,7 @@ void reserve::mint(extended_asset derivative, extended_asset underlying, std::ve
    token(_self).transfer(basename(derivative.contract), _self, underlying, "deposit in reserve");
 
    // create derivative token
-   token(token_account).mint(derivative, opts);
+   token(token_account).mint(derivative, std::move(opts));
 }
 
 void reserve::claim(name owner, extended_asset value) {
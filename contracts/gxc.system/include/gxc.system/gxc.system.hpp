@@ -27,7 +27,7 @@ struct [[eosio::table("global"), eosio::contract("gxc.system")]] gxc_global_stat
    int64_t  total_ram_stake = 0;
    uint16_t new_ram_per_block = 0;
    block_timestamp last_ram_increase;
-   block_timestamp last_block_num;
+   block_timestamp last_block_num; // deprecated, kept for layout compatibility (see `block_info`)
    uint8_t  revision = 0;
 
 #ifdef TARGET_MAINNET
@@ -43,6 +43,13 @@ struct [[eosio::table("global"), eosio::contract("gxc.system")]] gxc_global_stat
    )
 };
 
+// Updated by `onblock` every block, so kept apart from `gxc_global_state` to make the write small.
+struct [[eosio::table("blockinfo"), eosio::contract("gxc.system")]] gxc_block_info {
+   block_timestamp last_block_num;
+
+   EOSLIB_SERIALIZE(gxc_block_info, (last_block_num))
+};
+
 class [[eosio::contract("gxc.system")]] system_contract : public contract {
 public:
    system_contract(name s, name code, datastream<const char*> ds);
@@ -165,9 +172,11 @@ public:
 
 private:
    using global_state_singleton = eosio::singleton<"global"_n, gxc_global_state>;
+   using block_info_singleton = eosio::singleton<"blockinfo"_n, gxc_block_info>;
    rammarket               _rammarket;
    global_state_singleton  _global;
    gxc_global_state        _gstate;
+   bool                    _gstate_dirty = false; // `_gstate` is written back only when set
 
    static symbol get_core_symbol(const rammarket& rm) {
       auto itr = rm.find(ramcore_symbol.raw());
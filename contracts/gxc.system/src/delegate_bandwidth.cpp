@@ -133,6 +133,7 @@ void system_contract::buyram( name payer, name receiver, asset quant ) {
 
    _gstate.total_ram_bytes_reserved += uint64_t(bytes_out);
    _gstate.total_ram_stake          += quant_after_fee.amount;
+   _gstate_dirty = true;
 
    user_resources_table  userres( _self, receiver.value );
    auto res_itr = userres.find( receiver.value );
@@ -181,6 +182,7 @@ void system_contract::sellram( name account, int64_t bytes ) {
 
    _gstate.total_ram_bytes_reserved -= static_cast<decltype(_gstate.total_ram_bytes_reserved)>(bytes); // bytes > 0 is asserted above
    _gstate.total_ram_stake          -= tokens_out.amount;
+   _gstate_dirty = true;
 
    //// this shouldn't happen, but just in case it does we should prevent it
    check( _gstate.total_ram_stake >= 0, "error, attempt to unstake more tokens than previously staked" );
@@ -403,6 +405,7 @@ void system_contract::setramgift(uint8_t kbytes) {
    require_auth(_self);
 #ifdef TARGET_MAINNET
    _gstate.ram_gift_kbytes = kbytes;
+   _gstate_dirty = true;
 #else
    check(false, "not possible to adjust ram gift in testnet");
 #endif
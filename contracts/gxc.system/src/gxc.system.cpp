@@ -14,7 +14,12 @@ system_contract::system_contract(name s, name code, datastream<const char*> ds)
 : contract(s, code, ds)
 , _rammarket(_self, _self.value)
 , _global(_self, _self.value) {
-   _gstate = _global.exists() ? _global.get() : get_default_parameters();
+   if (_global.exists()) {
+      _gstate = _global.get();
+   } else {
+      _gstate = get_default_parameters();
+      _gstate_dirty = true;
+   }
 
 #ifdef TARGET_MAINNET
    ram_gift_bytes = _gstate.ram_gift_kbytes * 1024;
@@ -22,7 +27,8 @@ system_contract::system_contract(name s, name code, datastream<const char*> ds)
 }
 
 system_contract::~system_contract() {
-   _global.set(_gstate, _self);
+   if (_gstate_dirty)
+      _global.set(_gstate, _self);
 }
 
 gxc_global_state system_contract::get_default_parameters() {
@@ -54,6 +60,7 @@ void system_contract::setram( uint64_t max_ram_size ) {
    });
 
    _gstate.max_ram_size = max_ram_size;
+   _gstate_dirty = true;
 }
 
 void system_contract::update_ram_supply() {
@@ -72,6 +79,7 @@ void system_contract::update_ram_supply() {
       m.base.balance.amount += new_ram;
    });
    _gstate.last_ram_increase = cbt;
+   _gstate_dirty = true;
 }
 
 /**
@@ -86,12 +94,14 @@ void system_contract::setramrate( uint16_t bytes_per_block ) {
 
    update_ram_supply();
    _gstate.new_ram_per_block = bytes_per_block;
+   _gstate_dirty = true;
 }
 
 void system_contract::setparams( const gxc::blockchain_parameters& params ) {
    require_auth( _self );
    (gxc::blockchain_parameters&)(_gstate) = params;
    check( 3 <= _gstate.max_authority_depth, "max_authority_depth should be at least 3" );
+   _gstate_dirty = true;
    set_blockchain_parameters( params );
 }
 
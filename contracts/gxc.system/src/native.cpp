@@ -13,7 +13,7 @@ void system_contract::onblock(ignore<block_header> header) {
    block_timestamp timestamp;
    _ds >> timestamp;
 
-   _gstate.last_block_num = timestamp;
+   block_info_singleton(_self, _self.value).set({timestamp}, _self);
 }
 
 void system_contract::newaccount(name creator, name name, ignore<authority> owner, ignore<authority> active) {
@@ -9,6 +9,10 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 #include <eosio/system.hpp>
+#include <eosio/singleton.hpp>
+#include <eosio/binary_extension.hpp>
+
+#include <optional>
 
 #include <eoslib/symbol.hpp>
 #include <gxclib/action.hpp>
@@ -18,6 +22,8 @@ using namespace eosio;
 namespace gxc {
 
    constexpr name active_permission {"active"_n};
+   constexpr name system_account    {"gxc"_n};
+   constexpr name null_account      {"gxc.null"_n};
    constexpr uint64_t MASK_4BITS = 0xFull;
 
    class [[eosio::contract("gxc.token")]] token_contract : public contract {
@@ -25,6 +31,23 @@ namespace gxc {
       using contract::contract;
       using key_value = std::pair<std::string, std::vector<int8_t>>;
 
+      struct transfer_param {
+         name           to;
+         extended_asset value;
+         std::string    memo;
+
+         EOSLIB_SERIALIZE(transfer_param, (to)(value)(memo))
+      };
+
+      struct transfer_leg {
+         name           from;
+         name           to;
+         extended_asset value;
+         std::string    memo;
+
+         EOSLIB_SERIALIZE(transfer_leg, (from)(to)(value)(memo))
+      };
+
       void regtoken(name issuer, symbol_code symbol, name contract);
 
       // ACTION LIST BEGIN
@@ -35,6 +58,12 @@ namespace gxc {
       [[eosio::action]]
       void transfer(name from, name to, extended_asset value, std::string memo);
 
+      [[eosio::action]]
+      void transferbatch(name from, std::vector<transfer_param> transfers);
+
+      [[eosio::action]]
+      void settle(name settler, std::vector<transfer_leg> legs);
+
       [[eosio::action]]
       void burn(extended_asset value, std::string memo);
 
@@ -67,7 +96,14 @@ namespace gxc {
       typedef action_wrapper<"clrwithdraws"_n, &token_contract::clrwithdraws> clear_withdraws;
 
       [[eosio::action]]
-      void approve(name owner, name spender, extended_asset value);
+      void approve(name owner, name spender, extended_asset value,
+                   binary_extension<time_point_sec> expiration = binary_extension<time_point_sec>());
+
+      [[eosio::action]]
+      void revokeall(name owner, std::optional<name> spender);
+
+      [[eosio::action]]
+      void setstatext(name issuer, symbol_code symbol, int64_t holders, int64_t deposit, int64_t frozen);
 
       // dummy actions
       [[eosio::action]]
@@ -81,8 +117,7 @@ namespace gxc {
       // ACTION LIST END
 
       static uint64_t get_token_id(const extended_asset& value) {
-         auto sym_code = extended_symbol_code(value.quantity.symbol.code(), value.contract);
-         return token_hash(reinterpret_cast<const char*>(&sym_code), sizeof(uint128_t));
+         return token_hash(extended_symbol_code(value.quantity.symbol.code(), value.contract));
       }
 
       // To reduce ram usage, some fields in a row of multi-index table store more than one type of info.
@@ -176,6 +211,21 @@ namespace gxc {
 
       typedef multi_index<"stat"_n, currency_stats> stat;
 
+      // aggregates over `accounts` rows of a token, kept beside `stat` row not to change its layout
+      // amount of pending withdrawals is the balance of the contract's own row, so it is not kept here
+      struct [[eosio::table("statext"), eosio::contract("gxc.token")]] currency_stats_ext {
+         symbol  sym;         //  8
+         int64_t holders = 0; // 16, rows of accounts except the contract itself
+         int64_t deposit = 0; // 24, sum of deposits
+         int64_t frozen = 0;  // 32, frozen accounts
+
+         uint64_t primary_key()const { return sym.code().raw(); }
+
+         EOSLIB_SERIALIZE(currency_stats_ext, (sym)(holders)(deposit)(frozen))
+      };
+
+      typedef multi_index<"statext"_n, currency_stats_ext> statext;
+
       struct [[eosio::table("withdraws"), eosio::contract("gxc.token")]] withdrawal_request {
          asset          quantity;
          name           issuer;
@@ -193,31 +243,47 @@ namespace gxc {
                  indexed_by<"schedtime"_n, const_mem_fun<withdrawal_request, uint64_t, &withdrawal_request::by_scheduled_time>>
               > withdraws;
 
+      // wake-up time of the deferred `clrwithdraws` currently scheduled for owner
+      struct [[eosio::table("schedule"), eosio::contract("gxc.token")]] withdrawal_schedule {
+         time_point_sec scheduled_time;
+
+         EOSLIB_SERIALIZE(withdrawal_schedule, (scheduled_time))
+      };
+
+      typedef singleton<"schedule"_n, withdrawal_schedule> schedule;
+
       struct [[eosio::table("allowance"), eosio::contract("gxc.token")]] allowance {
          name  spender;  //  8
          asset quantity; // 24
          name  issuer;   // 32
+         binary_extension<time_point_sec> expiration; // 36, absent if never expires
 
-         static uint64_t get_approval_id(name spender, extended_asset value) {
-            std::array<char,24> raw;
-            auto sym_code = extended_symbol_code(value.quantity.symbol.code(), value.contract).raw();
-            datastream<char*> ds(raw.data(), raw.size());
-            ds << spender;
-            ds << sym_code;
-            return token_hash(raw.data(), raw.size());
+         // hash of serialized spender and extended symbol code
+         static uint64_t get_approval_id(name spender, const extended_asset& value) {
+            return token_hash(spender.value, extended_symbol_code(value.quantity.symbol.code(), value.contract));
          }
 
          inline extended_asset value()const { return extended_asset(quantity, issuer); }
 
          uint64_t primary_key()const { return get_approval_id(spender, extended_asset(quantity, issuer)); }
+         uint64_t by_spender()const { return spender.value; }
+         uint64_t by_expiry()const {
+            return expiration.has_value() ? expiration.value().sec_since_epoch() : std::numeric_limits<uint64_t>::max();
+         }
+
+         bool expired(time_point_sec now)const { return by_expiry() <= now.sec_since_epoch(); }
 
-         EOSLIB_SERIALIZE(allowance, (spender)(quantity)(issuer))
+         EOSLIB_SERIALIZE(allowance, (spender)(quantity)(issuer)(expiration))
       };
 
-      typedef multi_index<"allowance"_n, allowance> allowed;
+      // rows approved before secondary indices were added have no secondary entries until expiration is changed
+      typedef multi_index<"allowance"_n, allowance,
+         indexed_by<"byspender"_n, const_mem_fun<allowance, uint64_t, &allowance::by_spender>>,
+         indexed_by<"byexpiry"_n, const_mem_fun<allowance, uint64_t, &allowance::by_expiry>>
+      > allowed;
 
    private:
-      static void check_asset_is_valid(asset quantity, bool zeroable = false) {
+      static void check_asset_is_valid(const asset& quantity, bool zeroable = false) {
          check(quantity.symbol.is_valid(), "invalid symbol name `" + quantity.symbol.code().to_string() + "`");
          check(quantity.is_valid(), "invalid quantity");
          if (zeroable)
@@ -226,20 +292,30 @@ namespace gxc {
             check(quantity.amount > 0, "must be positive quantity");
       }
 
-      static void check_asset_is_valid(extended_asset value, bool zeroable = false) {
+      static void check_asset_is_valid(const extended_asset& value, bool zeroable = false) {
          check_asset_is_valid(value.quantity, zeroable);
       }
 
+      // expired allowances are erased by a few in approve and approved transfer of the same owner,
+      // and all allowances by `revokeall` in batches
+      static constexpr uint32_t prune_allowances_limit = 2;
+      static constexpr uint32_t revoke_allowances_limit = 100;
+
+      static void prune_allowances(allowed& _allowed, time_point_sec now);
+
       class token;
       class account;
       class requests;
 
+      void _transfer(token& _token, name from, name to, const extended_asset& value, const std::string& memo);
+
       class token : public multi_index_wrapper<stat> {
       public:
          using opt = currency_stats::opt;
 
          token(name code, name scope, symbol_code symbol)
          : multi_index_wrapper(code, scope, symbol.raw())
+         , _ext(code, scope.value)
          {}
 
          token(name code, name scope, symbol symbol)
@@ -250,12 +326,26 @@ namespace gxc {
          : token(code, value.contract, value.quantity.symbol)
          {}
 
+         // authorization of transfer resolved by validation stage
+         struct transfer_auth {
+            bool recall  = false; // recalled from deposit by issuer
+            bool allowed = false; // spent on allowance by `to`, which is looked up when spent
+            name payer;           // ram payer of `to`
+         };
+
          void mint(extended_asset value, const std::vector<key_value>& opts);
          void setopts(const std::vector<key_value>& opts);
-         void issue(name to, extended_asset quantity);
+
+         // validation stage of issue, retire and transfer, which runs all stateless checks
+         // and authorization once, followed by one of mutation stages below
+         transfer_auth validate_transfer(name from, name to, const extended_asset& value);
+
+         void issue(name to, const extended_asset& value, const transfer_auth& auth);
+         void retire(name owner, const extended_asset& value, const transfer_auth& auth);
+         void transfer(name from, name to, const extended_asset& value, const transfer_auth& auth);
+
          void burn(extended_asset quantity);
-         void retire(name owner, extended_asset quantity);
-         void transfer(name from, name to, extended_asset quantity);
+         void transfer_batch(name from, const std::vector<transfer_param>& transfers);
          void deposit(name owner, extended_asset value);
          void withdraw(name owner, extended_asset value);
          void cancel_withdraw(name owner, name issuer, symbol_code symbol);
@@ -267,7 +357,14 @@ namespace gxc {
 
          inline name issuer()const { return scope(); }
 
+         void setstatext(const currency_stats_ext& ext);
+
+         // adds deltas to `statext` row, tokens minted before the table was added are not counted until seeded
+         void update_ext(int64_t holders, int64_t deposit, int64_t frozen)const;
+
       private:
+         mutable statext _ext;
+
          void _setopts(const std::vector<key_value>& opts, bool init = false);
       };
 
@@ -289,10 +386,21 @@ namespace gxc {
             }
          }
 
+         // options decoded from key-value pairs, bits are indexed by `opt`
+         // an option given more than once is applied in order, so each value should differ from the previous one
+         struct opts_change {
+            uint8_t mask   = 0;
+            uint8_t first  = 0; // the first given values
+            uint8_t values = 0; // the last given values
+         };
+
+         static opts_change decode_opts(const std::vector<key_value>& opts, const token& st);
+
          void setopts(const std::vector<key_value>& opts);
+         void setopts(const opts_change& change);
          void open();
          void close();
-         void approve(name spender, extended_asset value);
+         void approve(name spender, const extended_asset& value, const binary_extension<time_point_sec>& expiration);
 
          inline name owner()const  { return scope(); }
          inline name issuer()const { return _st.scope(); }
@@ -321,15 +429,18 @@ namespace gxc {
 
       private:
          const token& _st;
-         bool  keep_balance;
-         bool  skip_valid;
+         bool  keep_balance = false;
+         bool  skip_valid = false;
          name  ram_payer = eosio::same_payer;
 
-         void sub_balance(extended_asset value);
-         void add_balance(extended_asset value);
-         void sub_deposit(extended_asset value);
-         void add_deposit(extended_asset value);
-         void sub_allowance(name spender, extended_asset value);
+         void sub_balance(const extended_asset& value);
+         void add_balance(const extended_asset& value);
+         void sub_deposit(const extended_asset& value);
+         void add_deposit(const extended_asset& value);
+         void sub_allowance(name spender, const extended_asset& value);
+
+         // reflects changes of this row to aggregates of the token, except the contract's own row
+         void update_ext(int64_t rows, int64_t deposit, int64_t frozen = 0)const;
 
          friend class token;
          friend class requests;
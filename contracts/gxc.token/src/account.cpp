@@ -3,33 +3,69 @@
  * @copyright defined in gxc/LICENSE
  */
 #include <gxc.token/gxc.token.hpp>
+#include <gxclib/options.hpp>
 
 namespace gxc {
 
+   static_assert(account_options::whitelist == token_contract::account_balance::whitelist, "account option ids mismatch");
+
+   token_contract::account::opts_change token_contract::account::decode_opts(const std::vector<key_value>& opts, const token& st) {
+      opts_change change;
+
+      for (const auto& o : opts) {
+         auto def = account_options::registry.find(o.first);
+         if (def == nullptr)
+            check(false, "unknown option `" + o.first + "`");
+
+         auto n = static_cast<opt>(def->id);
+         if (n == opt::frozen)
+            check(st->option(token::opt::freezable), "not configured to freeze account");
+         else if (n == opt::whitelist)
+            check(st->option(token::opt::whitelistable), "not configured to whitelist account");
+
+         bool value = unpack<bool>(o.second);
+         if ((change.mask >> n) & 0x1) {
+            check(((change.values >> n) & 0x1) != value, "option already has give value");
+         } else {
+            change.mask |= 0x1 << n;
+            if (value) change.first |= 0x1 << n;
+         }
+
+         if (value) change.values |= 0x1 << n;
+         else       change.values &= ~(0x1 << n);
+      }
+
+      return change;
+   }
+
    void token_contract::account::setopts(const std::vector<key_value>& opts) {
       check(opts.size(), "no changes on options");
       require_vauth(issuer());
 
+      setopts(decode_opts(opts, _st));
+   }
+
+   void token_contract::account::setopts(const opts_change& change) {
+      bool frozen = _this->option(opt::frozen);
+
       modify(ram_payer, [&](auto& a) {
-         for (auto o : opts) {
-            if (o.first == "frozen") {
-               check(_st->option(token::opt::freezable), "not configured to freeze account");
-               auto value = unpack<bool>(o.second);
-               check(a.option(opt::frozen) != value, "option already has give value");
-               a.option(opt::frozen, value);
-            } else if (o.first == "whitelist") {
-               check(_st->option(token::opt::whitelistable), "not configured to whitelist account");
-               auto value = unpack<bool>(o.second);
-               check(a.option(opt::whitelist) != value, "option already has give value");
-               a.option(opt::whitelist, value);
-            } else {
-               check(false, "unknown option `" + o.first + "`");
-            }
+         for (auto n : {opt::frozen, opt::whitelist}) {
+            if (!((change.mask >> n) & 0x1)) continue;
+            check(a.option(n) != bool((change.first >> n) & 0x1), "option already has give value");
+            a.option(n, (change.values >> n) & 0x1);
          }
       });
+
+      if (_this->option(opt::frozen) != frozen)
+         update_ext(0, 0, frozen ? -1 : 1);
+   }
+
+   void token_contract::account::update_ext(int64_t rows, int64_t deposit, int64_t frozen)const {
+      if (owner() != code())
+         _st.update_ext(rows, deposit, frozen);
    }
 
-   void token_contract::account::sub_balance(extended_asset value) {
+   void token_contract::account::sub_balance(const extended_asset& value) {
       check_account_is_valid();
       check(_this->balance.amount >= value.quantity.amount, "overdrawn balance");
 
@@ -37,6 +73,7 @@ namespace gxc {
           _this->balance.amount == value.quantity.amount && _this->deposit().amount == 0)
       {
          erase();
+         update_ext(-1, 0);
       } else {
          modify(ram_payer, [&](auto& a) {
             a.balance -= value.quantity;
@@ -44,7 +81,7 @@ namespace gxc {
       }
    }
 
-   void token_contract::account::add_balance(extended_asset value) {
+   void token_contract::account::add_balance(const extended_asset& value) {
       if (!exists()) {
          check(!_st->option(token::opt::whitelist_on) || has_vauth(value.contract), "required to open balance manually");
          emplace(ram_payer, [&](auto& a) {
@@ -52,6 +89,7 @@ namespace gxc {
             a.deposit(asset(0, value.quantity.symbol));
             a.issuer(value.contract);
          });
+         update_ext(1, 0);
       } else {
          check_account_is_valid();
          modify(ram_payer, [&](auto& a) {
@@ -60,7 +98,7 @@ namespace gxc {
       }
    }
 
-   void token_contract::account::sub_deposit(extended_asset value) {
+   void token_contract::account::sub_deposit(const extended_asset& value) {
       check_account_is_valid();
       check(_this->deposit().amount >= value.quantity.amount, "overdrawn deposit");
 
@@ -68,14 +106,16 @@ namespace gxc {
           _this->deposit().amount == value.quantity.amount && _this->balance.amount == 0)
       {
          erase();
+         update_ext(-1, -value.quantity.amount);
       } else {
          modify(ram_payer, [&](auto& a) {
             a.deposit(a.deposit() - value.quantity);
          });
+         update_ext(0, -value.quantity.amount);
       }
    }
 
-   void token_contract::account::add_deposit(extended_asset value) {
+   void token_contract::account::add_deposit(const extended_asset& value) {
       if (!exists()) {
          check(!_st->option(token::opt::whitelist_on) || has_vauth(value.contract), "required to open deposit manually");
          emplace(ram_payer, [&](auto& a) {
@@ -83,11 +123,13 @@ namespace gxc {
             a.deposit(value.quantity);
             a.issuer(value.contract);
          });
+         update_ext(1, value.quantity.amount);
       } else {
          check_account_is_valid();
          modify(ram_payer, [&](auto& a) {
             a.deposit(a.deposit() + value.quantity);
          });
+         update_ext(0, value.quantity.amount);
       }
    }
 
@@ -97,6 +139,7 @@ namespace gxc {
             a.balance.symbol = _st->supply.symbol;
             a.issuer(_st->issuer);
          });
+         update_ext(1, 0);
       }
    }
 
@@ -104,13 +147,19 @@ namespace gxc {
       require_auth(owner());
       check(exists(), "account balance doesn't exist");
       check(!_this->balance.amount && !_this->deposit().amount, "cannot close non-zero balance");
+
+      int64_t frozen = _this->option(opt::frozen) ? -1 : 0;
       erase();
+      update_ext(-1, 0, frozen);
    }
 
-   void token_contract::account::approve(name spender, extended_asset value) {
+   void token_contract::account::approve(name spender, const extended_asset& value, const binary_extension<time_point_sec>& expiration) {
       check_asset_is_valid(value, true);
       require_auth(owner());
 
+      auto now = time_point_sec(current_time_point());
+      check(!expiration.has_value() || expiration.value() > now, "expiration should be in the future");
+
       allowed _allowed(code(), owner().value);
 
       auto it = _allowed.find(allowance::get_approval_id(spender, value));
@@ -119,31 +168,49 @@ namespace gxc {
          check(value.quantity.amount > 0, "allowance not found");
 
          _allowed.emplace(owner(), [&](auto& a) {
-            a.spender  = spender;
-            a.quantity = value.quantity;
-            a.issuer   = value.contract;
+            a.spender    = spender;
+            a.quantity   = value.quantity;
+            a.issuer     = value.contract;
+            a.expiration = expiration;
          });
       } else if (value.quantity.amount > 0) {
-         _allowed.modify(it, owner(), [&](auto& a) {
-            a.quantity = value.quantity;
-         });
+         auto a = *it;
+         a.quantity   = value.quantity;
+         a.expiration = expiration;
+
+         if (a.by_expiry() == it->by_expiry()) {
+            _allowed.modify(it, owner(), [&](auto& r) { r = a; });
+         } else {
+            // rows approved before secondary indices have no entry to update, so the row is stored again
+            _allowed.erase(it);
+            _allowed.emplace(owner(), [&](auto& r) { r = a; });
+         }
       } else {
          _allowed.erase(it);
       }
+
+      prune_allowances(_allowed, now);
    }
 
-   void token_contract::account::sub_allowance(name spender, extended_asset value) {
+   void token_contract::account::sub_allowance(name spender, const extended_asset& value) {
       allowed _allowed(code(), owner().value);
 
-      const auto& it = _allowed.get(allowance::get_approval_id(spender, value));
+      // the only lookup of allowance in a transfer, authorization of spender is not granted without it
+      auto it = _allowed.find(allowance::get_approval_id(spender, value));
+      check(it != _allowed.end(), "Missing required authority");
+
+      auto now = time_point_sec(current_time_point());
+      check(!it->expired(now), "allowance expired");
 
-      if (it.quantity > value.quantity)
+      if (it->quantity > value.quantity)
          _allowed.modify(it, owner(), [&](auto& a) {
             a.quantity -= value.quantity;
          });
-      else if (it.quantity == value.quantity)
+      else if (it->quantity == value.quantity)
          _allowed.erase(it);
       else
          check(false, "try transfering more than allowed");
+
+      prune_allowances(_allowed, now);
    }
 }
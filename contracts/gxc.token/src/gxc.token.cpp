@@ -11,9 +11,6 @@
 
 namespace gxc {
 
-   constexpr name system_account {"gxc"_n};
-   constexpr name null_account   {"gxc.null"_n};
-
    void token_contract::regtoken(name issuer, symbol_code symbol, name contract) {
       require_auth(_self);
       check(false, "external tokens are not supported yet");
@@ -32,24 +29,68 @@ namespace gxc {
    }
 
    void token_contract::setacntsopts(std::vector<name> accounts, name issuer, symbol_code symbol, std::vector<key_value> opts) {
+      check(accounts.size(), "no accounts");
+
       auto _token = token(_self, issuer, symbol);
-      for (auto& account : accounts)
-         _token.get_account(account).setopts(opts);
+      check(_token, "token not found");
+
+      // options, authority and token id are the same for all accounts
+      check(opts.size(), "no changes on options");
+      require_vauth(_token.issuer());
+      auto change = account::decode_opts(opts, _token);
+      auto key = get_token_id(extended_asset(asset(0, _token->supply.symbol), _token.issuer()));
+
+      for (auto owner : accounts)
+         account(_self, owner, key, _token).setopts(change);
    }
 
    void token_contract::transfer(name from, name to, extended_asset value, std::string memo) {
+      auto _token = token(_self, value);
+      _transfer(_token, from, to, value, memo);
+   }
+
+   void token_contract::_transfer(token& _token, name from, name to, const extended_asset& value, const std::string& memo) {
       check(memo.size() <= 256, "memo has more than 256 bytes");
-      check(from != to, "cannot transfer to self");
-      check(is_account(to), "`to` account does not exist");
 
-      auto _token = token(_self, value);
+      auto auth = _token.validate_transfer(from, to, value);
 
       if (from == null_account)
-         _token.issue(to, value);
+         _token.issue(to, value, auth);
       else if (to == null_account)
-         _token.retire(from, value);
+         _token.retire(from, value, auth);
       else
-         _token.transfer(from, to, value);
+         _token.transfer(from, to, value, auth);
+   }
+
+   void token_contract::settle(name settler, std::vector<transfer_leg> legs) {
+      require_auth(settler);
+      check(rootname(settler) == system_account && settler != null_account, "settle is only allowed to system contracts");
+      check(legs.size(), "no transfers");
+
+      // consecutive legs of the same token share the loaded token
+      std::optional<token> _token;
+      extended_symbol_code sym_code;
+
+      for (const auto& l : legs) {
+         auto leg_sym_code = extended_symbol_code(l.value.quantity.symbol.code(), l.value.contract);
+         if (!_token || sym_code != leg_sym_code) {
+            _token.emplace(_self, l.value);
+            sym_code = leg_sym_code;
+         }
+         _transfer(*_token, l.from, l.to, l.value, l.memo);
+      }
+   }
+
+   void token_contract::transferbatch(name from, std::vector<transfer_param> transfers) {
+      check(transfers.size(), "no transfers");
+      check(from != null_account, "cannot issue in batch");
+
+      for (const auto& t : transfers) {
+         check(t.memo.size() <= 256, "memo has more than 256 bytes");
+         check(t.to != null_account, "cannot retire in batch");
+      }
+
+      token(_self, transfers.front().value).transfer_batch(from, transfers);
    }
 
    void token_contract::burn(extended_asset value, std::string memo) {
@@ -82,7 +123,48 @@ namespace gxc {
       requests(_self, owner).clear();
    }
 
-   void token_contract::approve(name owner, name spender, extended_asset value) {
-      token(_self, value).get_account(owner).approve(spender, value);
+   void token_contract::approve(name owner, name spender, extended_asset value, binary_extension<time_point_sec> expiration) {
+      token(_self, value).get_account(owner).approve(spender, value, expiration);
+   }
+
+   void token_contract::revokeall(name owner, std::optional<name> spender) {
+      require_auth(owner);
+
+      allowed _allowed(_self, owner.value);
+      uint32_t count = 0;
+
+      if (spender) {
+         auto _idx = _allowed.get_index<"byspender"_n>();
+         for (auto it = _idx.lower_bound(spender->value);
+              it != _idx.end() && it->spender == *spender && count < revoke_allowances_limit; ++count)
+            it = _idx.erase(it);
+
+         // rows approved before secondary indices were added are not in `byspender`
+         for (auto it = _allowed.begin(); it != _allowed.end() && count < revoke_allowances_limit;) {
+            if (it->spender == *spender) {
+               it = _allowed.erase(it);
+               ++count;
+            } else {
+               ++it;
+            }
+         }
+      } else {
+         for (auto it = _allowed.begin(); it != _allowed.end() && count < revoke_allowances_limit; ++count)
+            it = _allowed.erase(it);
+      }
+
+      check(count > 0, "allowance not found");
+   }
+
+   void token_contract::setstatext(name issuer, symbol_code symbol, int64_t holders, int64_t deposit, int64_t frozen) {
+      token(_self, issuer, symbol).setstatext({eosio::symbol(), holders, deposit, frozen});
+   }
+
+   void token_contract::prune_allowances(allowed& _allowed, time_point_sec now) {
+      auto _idx = _allowed.get_index<"byexpiry"_n>();
+      uint32_t count = 0;
+
+      for (auto it = _idx.begin(); it != _idx.end() && it->expired(now) && count < prune_allowances_limit; ++count)
+         it = _idx.erase(it);
    }
 }
@@ -11,18 +11,40 @@ namespace gxc {
       auto _idx = get_index<"schedtime"_n>();
       auto _it = _idx.begin();
 
-      cancel_deferred(owner().value);
+      auto _sched = schedule(code(), owner().value);
+      bool scheduled = _sched.exists();
 
-      if (_it != _idx.end()) {
-         auto timeleft = (_it->scheduled_time - current_time_point()).to_seconds();
-         if (timeleft <= 0) {
-            clear_withdraws(code(), {owner(), active_permission}).send(owner());
-         } else {
-            transaction out;
-            out.actions.emplace_back(action{{owner(), active_permission}, code(), "clrwithdraws"_n, owner()});
-            out.delay_sec = static_cast<uint32_t>(timeleft);
-            out.send(owner().value, owner(), true);
+      if (_it == _idx.end()) {
+         if (scheduled) {
+            cancel_deferred(owner().value);
+            _sched.remove();
          }
+         return;
+      }
+
+      auto now = current_time_point();
+
+      // keep the pending wake-up unless the head moved earlier or it has already passed,
+      // waking up earlier than the head only results in rescheduling by `clear()`
+      if (scheduled) {
+         auto wakeup = _sched.get().scheduled_time;
+         if (wakeup <= _it->scheduled_time && wakeup > now) return;
+         cancel_deferred(owner().value);
+      }
+
+      // the owner is charged only when authorized, not when a request is cancelled by recall of the issuer
+      auto payer = has_auth(owner()) ? owner() : code();
+
+      auto timeleft = (_it->scheduled_time - now).to_seconds();
+      if (timeleft <= 0) {
+         if (scheduled) _sched.remove();
+         clear_withdraws(code(), {owner(), active_permission}).send(owner());
+      } else {
+         transaction out;
+         out.actions.emplace_back(action{{owner(), active_permission}, code(), "clrwithdraws"_n, owner()});
+         out.delay_sec = static_cast<uint32_t>(timeleft);
+         out.send(owner().value, payer, true);
+         _sched.set({_it->scheduled_time}, payer);
       }
    }
 
@@ -34,19 +56,22 @@ namespace gxc {
 
       check(_it != _idx.end(), "withdrawal requests not found");
 
-      for ( ; _it != _idx.end(); _it = _idx.begin()) {
-         auto _token = token(code(), _it->issuer, _it->quantity.symbol);
-         if (_it->scheduled_time > current_time_point()) break;
+      auto now = current_time_point();
+
+      // requests are keyed by token id, so each token is loaded once anyway
+      for ( ; _it != _idx.end() && _it->scheduled_time <= now; _it = _idx.begin()) {
+         auto value = _it->value();
+         auto _token = token(code(), value);
 
-         _token.get_account(code()).sub_balance(_it->value());
+         _token.get_account(code()).sub_balance(value);
 
          auto _owner = _token.get_account(owner());
          if (!_owner->option(account::opt::frozen)) {
-            _owner.paid_by(owner()).add_balance(_it->value());
-            withdraw_processed(code(), {code(), active_permission}).send(owner(), _it->value());
+            _owner.paid_by(owner()).add_balance(value);
+            withdraw_processed(code(), {code(), active_permission}).send(owner(), value);
          } else {
-            _owner.skip_validation().add_deposit(_it->value());
-            withdraw_reverted(code(), {code(), active_permission}).send(owner(), _it->value());
+            _owner.skip_validation().add_deposit(value);
+            withdraw_reverted(code(), {code(), active_permission}).send(owner(), value);
          }
 
          _idx.erase(_it);
@@ -5,9 +5,12 @@
 
 #include <gxc.token/gxc.token.hpp>
 #include <gxclib/game.hpp>
+#include <gxclib/options.hpp>
 
 namespace gxc {
 
+   static_assert(token_options::whitelist_on == token_contract::currency_stats::whitelist_on, "token option ids mismatch");
+
    void token_contract::token::mint(extended_asset value, const std::vector<key_value>& opts) {
       require_auth(code());
       check_asset_is_valid(value);
@@ -23,6 +26,9 @@ namespace gxc {
             t.max_supply(value.quantity);
             t.issuer        = value.contract;
          });
+         _ext.emplace(code(), [&](auto& e) {
+            e.sym = value.quantity.symbol;
+         });
       } else {
          check(_this->option(opt::mintable), "not allowed additional mint");
          modify(same_payer, [&](auto& t) {
@@ -35,35 +41,28 @@ namespace gxc {
 
    void token_contract::token::_setopts(const std::vector<key_value>& opts, bool init) {
       modify(same_payer, [&](auto& t) {
-         for (auto o : opts) {
-            if (o.first == "paused")
-               t.option(opt::paused, unpack<bool>(o.second));
-            else if (o.first == "whitelist_on")
-               t.option(opt::whitelist_on, unpack<bool>(o.second));
-            else {
-               // Below options can be configured only when creating token.
-               check(init, "not allowed to change the option `" + o.first + "`");
-
-               if (o.first == "mintable") {
-                  t.option(opt::mintable, unpack<bool>(o.second));
-               } else if (o.first == "recallable") {
-                  t.option(opt::recallable, unpack<bool>(o.second));
-               } else if (o.first == "freezable") {
-                  t.option(opt::freezable, unpack<bool>(o.second));
-               } else if (o.first == "pausable") {
-                  t.option(opt::pausable, unpack<bool>(o.second));
-               } else if (o.first == "whitelistable") {
-                  t.option(opt::whitelistable, unpack<bool>(o.second));
-               } else if (o.first == "withdraw_min_amount") {
+         for (const auto& o : opts) {
+            // messages are built only on failure, not to allocate for each option
+            auto def = token_options::registry.find(o.first);
+            if (def == nullptr)
+               check(false, "unknown option `" + o.first + "`");
+            if (!init && (def->flags & token_options::init_only))
+               check(false, "not allowed to change the option `" + o.first + "`");
+
+            switch (def->id) {
+               case token_options::withdraw_min_amount: {
                   auto value = unpack<int64_t>(o.second);
                   check(value >= 0, "withdraw_min_amount should be positive");
                   t.withdraw_min_amount(asset(value, t.supply.symbol));
-               } else if (o.first == "withdraw_delay_sec") {
+                  break;
+               }
+               case token_options::withdraw_delay_sec: {
                   auto value = unpack<uint64_t>(o.second);
                   t.withdraw_delay_sec = static_cast<uint32_t>(value);
-               } else {
-                  check(false, "unknown option `" + o.first + "`");
+                  break;
                }
+               default:
+                  t.option(static_cast<opt>(def->id), unpack<bool>(o.second));
             }
          }
       });
@@ -79,49 +78,100 @@ namespace gxc {
       _setopts(opts);
    }
 
-   void token_contract::token::issue(name to, extended_asset value) {
-      require_vauth(value.contract);
+   void token_contract::token::setstatext(const currency_stats_ext& ext) {
+      require_auth(code());
+      check(exists(), "token not found");
+      check(ext.holders >= 0 && ext.deposit >= 0 && ext.frozen >= 0, "must not be negative");
+      // only seeded once, aggregates are maintained by actions from then on
+      check(_ext.find(_this->supply.symbol.code().raw()) == _ext.end(), "statext already seeded");
+
+      _ext.emplace(code(), [&](auto& e) {
+         e     = ext;
+         e.sym = _this->supply.symbol;
+      });
+   }
+
+   void token_contract::token::update_ext(int64_t holders, int64_t deposit, int64_t frozen)const {
+      if (!holders && !deposit && !frozen) return;
+
+      auto it = _ext.find(_this->supply.symbol.code().raw());
+      if (it == _ext.end()) return;
+
+      _ext.modify(it, same_payer, [&](auto& e) {
+         e.holders += holders;
+         e.deposit += deposit;
+         e.frozen  += frozen;
+      });
+   }
+
+   token_contract::token::transfer_auth token_contract::token::validate_transfer(name from, name to, const extended_asset& value) {
+      check(from != to, "cannot transfer to self");
       check_asset_is_valid(value);
+      check(exists(), "token not found");
 
       //TODO: check game account
       check(value.quantity.symbol == _this->supply.symbol, "symbol precision mismatch");
-      check(value.quantity.amount <= _this->max_supply().amount - _this->supply.amount, "quantity exceeds available supply");
 
+      transfer_auth auth;
+
+      if (from == null_account) {
+         check(is_account(to), "`to` account does not exist");
+         require_vauth(value.contract);
+         check(value.quantity.amount <= _this->max_supply().amount - _this->supply.amount, "quantity exceeds available supply");
+
+         auth.payer = (value.contract == system_account || has_gauth(value.contract)) ? code() : value.contract;
+         return auth;
+      }
+
+      if (to != null_account) {
+         check(is_account(to), "`to` account does not exist");
+         check(!_this->option(opt::paused), "token is paused");
+      }
+
+      bool to_auth = false;
+
+      if (!has_auth(from)) {
+         if (_this->option(opt::recallable) && has_vauth(value.contract)) {
+            auth.recall = true;
+         } else if (to != null_account && (to_auth = has_auth(to))) {
+            auth.allowed = true;
+         }
+         check(auth.recall || auth.allowed, "Missing required authority");
+      } else if (to != null_account) {
+         to_auth = has_auth(to);
+      }
+
+      // case recall : in-game transfer
+      // case to_auth: approved transfer
+      // case else   : all other cases
+      if (auth.recall) auth.payer = code();
+      else if (to_auth) auth.payer = to;
+      else auth.payer = from;
+
+      return auth;
+   }
+
+   void token_contract::token::issue(name to, const extended_asset& value, const transfer_auth& auth) {
       modify(same_payer, [&](auto& s) {
          s.supply += value.quantity;
       });
 
-      name payer = (value.contract == "gxc"_n || has_gauth(value.contract)) ? code() : value.contract;
-
       auto _to = get_account(to);
 
       if (_this->option(opt::recallable) && (to != value.contract))
          _to.paid_by(code()).add_deposit(value);
       else
-         _to.paid_by(payer).add_balance(value);
-
+         _to.paid_by(auth.payer).add_balance(value);
    }
 
-   void token_contract::token::retire(name owner, extended_asset value) {
-      check_asset_is_valid(value);
-
-      //TODO: check game account
-      check(value.quantity.symbol == _this->supply.symbol, "symbol precision mismatch");
-
-      bool is_recall = false;
-
-      if (!has_auth(owner)) {
-         check(_this->option(opt::recallable) && has_vauth(value.contract), "Missing required authority");
-         is_recall = true;
-      }
-
+   void token_contract::token::retire(name owner, const extended_asset& value, const transfer_auth& auth) {
       modify(same_payer, [&](auto& s) {
          s.supply -= value.quantity;
       });
 
       auto _to = get_account(owner);
 
-      if (!is_recall)
+      if (!auth.recall)
          _to.sub_balance(value);
       else
          _to.paid_by(code()).sub_deposit(value);
@@ -144,34 +194,14 @@ namespace gxc {
       get_account(value.contract).sub_balance(value);
    }
 
-   void token_contract::token::transfer(name from, name to, extended_asset value) {
-      check(from != to, "cannot transfer to self");
-      check(is_account(to), "`to` account does not exist");
-
-      check_asset_is_valid(value);
-      check(!_this->option(opt::paused), "token is paused");
-
-      bool is_recall = false;
-      bool is_allowed = false;
-
-      if (!has_auth(from)) {
-         if (_this->option(opt::recallable) && has_vauth(value.contract)) {
-            is_recall = true;
-         } else if (has_auth(to)) {
-            allowed _allowed(code(), from.value);
-            auto it = _allowed.find(allowance::get_approval_id(to, value));
-            is_allowed = (it != _allowed.end());
-         }
-         check(is_recall || is_allowed, "Missing required authority");
-      }
-
+   void token_contract::token::transfer(name from, name to, const extended_asset& value, const transfer_auth& auth) {
       // subtract asset from `from`
       auto _from = get_account(from);
 
-      if (is_allowed)
+      if (auth.allowed)
          _from.sub_allowance(to, value);
 
-      if (!is_recall) {
+      if (!auth.recall) {
          _from.sub_balance(value);
       } else {
          // normal case, transfer from's deposit
@@ -200,17 +230,55 @@ namespace gxc {
          }
       }
 
-      name payer;
+      // add asset to `to`
+      get_account(to).paid_by(auth.payer).add_balance(value);
+   }
 
-      // case is_recall   : in-game transfer
-      // case has_auth(to): approved transfer
-      // case else        : all other cases
-      if (is_recall) payer = code();
-      else if (has_auth(to)) payer = to;
-      else payer = from;
+   void token_contract::token::transfer_batch(name from, const std::vector<transfer_param>& transfers) {
+      require_auth(from);
+      check(exists(), "token not found");
+      check(!_this->option(opt::paused), "token is paused");
 
-      // add asset to `to`
-      get_account(to).paid_by(payer).add_balance(value);
+      std::vector<std::pair<name, int64_t>> legs;
+      legs.reserve(transfers.size());
+
+      int64_t total = 0;
+      for (const auto& t : transfers) {
+         check(t.value.contract == issuer() && t.value.quantity.symbol == _this->supply.symbol,
+               "all transfers should be of the same token");
+         check(t.value.quantity.is_valid(), "invalid quantity");
+         check(t.value.quantity.amount > 0, "must be positive quantity");
+         check(t.to != from, "cannot transfer to self");
+
+         total += t.value.quantity.amount;
+         check(total <= asset::max_amount, "total quantity overflow");
+
+         legs.emplace_back(t.to, t.value.quantity.amount);
+      }
+
+      // merge legs by recipient, so that each recipient row is touched only once
+      std::sort(legs.begin(), legs.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+      std::vector<std::pair<name, int64_t>> credits;
+      credits.reserve(legs.size());
+      for (const auto& l : legs) {
+         if (credits.size() && credits.back().first == l.first)
+            credits.back().second += l.second;
+         else
+            credits.push_back(l);
+      }
+
+      auto sym = extended_symbol(_this->supply.symbol, issuer());
+      auto key = get_token_id(extended_asset(0, sym));
+
+      // subtract asset from `from` at once
+      account(code(), from, key, *this).sub_balance(extended_asset(total, sym));
+
+      // add asset to each `to`
+      for (const auto& c : credits) {
+         check(is_account(c.first), "`to` account does not exist");
+         account(code(), c.first, key, *this).paid_by(from).add_balance(extended_asset(c.second, sym));
+      }
    }
 
    void token_contract::token::deposit(name owner, extended_asset value) {
@@ -264,5 +332,6 @@ namespace gxc {
       withdraw_reverted(code(), {code(), active_permission}).send(owner, value);
 
       _req.erase();
+      _req.refresh_schedule();
    }
 }
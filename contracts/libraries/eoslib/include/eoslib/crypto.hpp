@@ -3,6 +3,7 @@
  */
 #pragma once
 #include <cstdint>
+#include <initializer_list>
 
 namespace eosio {
 
@@ -62,4 +63,112 @@ namespace eosio {
     * @return uint64_t - Computed value
     */
    uint64_t xxh64(const char* data, uint32_t length, uint64_t seed = 0);
+
+   namespace _crypto_detail {
+      constexpr uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+      constexpr uint64_t xxh64_round(uint64_t acc, uint64_t input) {
+         return rotl64(acc + input * 14029467366897019727ULL, 31) * 11400714785074694791ULL;
+      }
+
+      constexpr uint64_t xxh64_avalanche(uint64_t h) {
+         h ^= h >> 33;
+         h *= 14029467366897019727ULL;
+         h ^= h >> 29;
+         h *= 1609587929392839161ULL;
+         h ^= h >> 32;
+         return h;
+      }
+
+      constexpr uint64_t fasthash_mix(uint64_t h) {
+         h ^= h >> 23;
+         h *= 0x2127599bf4325c37ULL;
+         h ^= h >> 47;
+         return h;
+      }
+   }
+
+   /**
+    * Hashes 16 bytes of `lo` followed by `hi` (little-endian) using xxHash64.
+    * Same result as `xxh64` over the raw 128-bit value, without the generic length dispatch.
+    * @brief Hashes 128-bit value using xxHash64
+    *
+    * @param lo - Lower 64 bits of data
+    * @param hi - Upper 64 bits of data
+    * @param seed - Hash seed
+    * @return uint64_t - Computed value
+    */
+   constexpr uint64_t xxh64_128(uint64_t lo, uint64_t hi, uint64_t seed = 0) {
+      using namespace _crypto_detail;
+      uint64_t h = seed + 2870177450012600261ULL + 16;
+      h ^= xxh64_round(0, lo);
+      h  = rotl64(h, 27) * 11400714785074694791ULL + 9650029242287828579ULL;
+      h ^= xxh64_round(0, hi);
+      h  = rotl64(h, 27) * 11400714785074694791ULL + 9650029242287828579ULL;
+      return xxh64_avalanche(h);
+   }
+
+   /**
+    * Hashes 24 bytes of `a`, `b` and `c` in order (little-endian) using xxHash64.
+    * Same result as `xxh64` over the raw three words.
+    * @brief Hashes 192-bit value using xxHash64
+    *
+    * @param a - First 64 bits of data
+    * @param b - Second 64 bits of data
+    * @param c - Last 64 bits of data
+    * @param seed - Hash seed
+    * @return uint64_t - Computed value
+    */
+   constexpr uint64_t xxh64_192(uint64_t a, uint64_t b, uint64_t c, uint64_t seed = 0) {
+      using namespace _crypto_detail;
+      uint64_t h = seed + 2870177450012600261ULL + 24;
+      for (auto lane : {a, b, c}) {
+         h ^= xxh64_round(0, lane);
+         h  = rotl64(h, 27) * 11400714785074694791ULL + 9650029242287828579ULL;
+      }
+      return xxh64_avalanche(h);
+   }
+
+   /**
+    * Hashes 16 bytes of `lo` followed by `hi` (little-endian) using fasthash64.
+    * Same result as `fasthash64` over the raw 128-bit value, without the generic length dispatch.
+    * @brief Hashes 128-bit value using fasthash64
+    *
+    * @param lo - Lower 64 bits of data
+    * @param hi - Upper 64 bits of data
+    * @param seed - Hash seed
+    * @return uint64_t - Computed value
+    */
+   constexpr uint64_t fasthash64_128(uint64_t lo, uint64_t hi, uint64_t seed = 0) {
+      using namespace _crypto_detail;
+      constexpr uint64_t m = 0x880355f21e6d1965ULL;
+      uint64_t h = seed ^ (16 * m);
+      h ^= fasthash_mix(lo);
+      h *= m;
+      h ^= fasthash_mix(hi);
+      h *= m;
+      return fasthash_mix(h);
+   }
+
+   /**
+    * Hashes 24 bytes of `a`, `b` and `c` in order (little-endian) using fasthash64.
+    * Same result as `fasthash64` over the raw three words.
+    * @brief Hashes 192-bit value using fasthash64
+    *
+    * @param a - First 64 bits of data
+    * @param b - Second 64 bits of data
+    * @param c - Last 64 bits of data
+    * @param seed - Hash seed
+    * @return uint64_t - Computed value
+    */
+   constexpr uint64_t fasthash64_192(uint64_t a, uint64_t b, uint64_t c, uint64_t seed = 0) {
+      using namespace _crypto_detail;
+      constexpr uint64_t m = 0x880355f21e6d1965ULL;
+      uint64_t h = seed ^ (24 * m);
+      for (auto lane : {a, b, c}) {
+         h ^= fasthash_mix(lane);
+         h *= m;
+      }
+      return fasthash_mix(h);
+   }
 }
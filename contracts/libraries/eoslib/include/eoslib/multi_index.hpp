@@ -56,12 +56,12 @@ namespace eosio {
 
       template<typename Lambda>
       void emplace(name payer, Lambda&& updater) {
-         _this = _tbl.emplace(payer, std::forward<Lambda&&>(updater));
+         _this = _tbl.emplace(payer, std::forward<Lambda>(updater));
       }
 
       template<typename Lambda>
       void modify(name payer, Lambda&& updater) {
-         _tbl.modify(_this, payer, std::forward<Lambda&&>(updater));
+         _tbl.modify(_this, payer, std::forward<Lambda>(updater));
       }
 
       void erase() { _this = _tbl.erase(_this); }
@@ -99,12 +99,12 @@ namespace eosio {
 
       template<typename Lambda>
       void emplace(name payer, Lambda&& updater) {
-         _this = _tbl.emplace(payer, std::forward<Lambda&&>(updater));
+         _this = _tbl.emplace(payer, std::forward<Lambda>(updater));
       }
 
       template<typename Lambda>
       void modify(name payer, Lambda&& updater) {
-         _tbl.modify(_this, payer, std::forward<Lambda&&>(updater));
+         _tbl.modify(_this, payer, std::forward<Lambda>(updater));
       }
 
       void erase() { _this = _tbl.erase(_this); }
@@ -4,25 +4,16 @@
  */
 #pragma once
 #include <eosio/action.hpp>
+#include <gxclib/basename.hpp>
 
 namespace eosio {
 
-name rootname(name n) {
-   auto mask = (uint64_t) -1;
-   for (auto i = 0; i < 12; ++i) {
-      if (n.value & (0x1FULL << (4 + 5 * (11 - i))))
-         continue;
-      mask <<= 4 + 5 * (11 - i);
-      break;
-   }
-   return name(n.value & mask);
+constexpr name rootname(name n) {
+   return name(gxc::name_bits::rootname(n.value));
 }
 
-name basename(name n) {
-   if (is_account(n))
-      return n;
-   else
-      return rootname(n);
+inline name basename(name n) {
+   return name(gxc::basename(n.value, [](uint64_t v) { return is_account(name(v)); }));
 }
 
 inline bool has_vauth(name n) {
@@ -0,0 +1,26 @@
+/**
+ * @file
+ * @copyright defined in gxc/LICENSE
+ */
+#pragma once
+
+#include <gxclib/cache.hpp>
+#include <gxclib/name_bits.hpp>
+
+namespace gxc {
+
+   /**
+    * Returns `n` if it is an existing account, or its root name otherwise, memoized for the action.
+    *
+    * `is_account` is the intrinsic in contracts (see `eosio::basename`), and may be replaced on host.
+    * Each type of `is_account` has its own cache.
+    */
+   template <typename IsAccount>
+   uint64_t basename(uint64_t n, IsAccount&& is_account) {
+      static action_cache<uint64_t, uint64_t> cache;
+      return cache.get(n, [&](uint64_t n) {
+         return is_account(n) ? n : name_bits::rootname(n);
+      });
+   }
+
+}
@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @copyright defined in gxc/LICENSE
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gxc {
+
+/**
+ * Static data is not initialized for each action on host, so host-side harnesses increment it at the start
+ * of each action to invalidate all caches. It stays zero on chain.
+ */
+inline uint64_t action_epoch = 0;
+
+/**
+ * Fixed-size memo of resolved values for a few keys.
+ *
+ * Static data of contract is initialized for each action, so a static instance works as an action-scoped cache.
+ * Only a handful of names are checked in an action, and keys beyond the capacity are resolved without caching.
+ * Host benchmarks define `GXC_NO_ACTION_CACHE` to resolve every key, for comparison with the cache.
+ */
+template <typename Key, typename Value, size_t N = 8>
+class action_cache {
+public:
+   template <typename Resolver>
+   Value get(const Key& key, Resolver&& resolve) {
+#ifdef GXC_NO_ACTION_CACHE
+      return resolve(key);
+#endif
+      if (_epoch != action_epoch) {
+         _size  = 0;
+         _epoch = action_epoch;
+      }
+
+      for (size_t i = 0; i < _size; ++i) {
+         if (_keys[i] == key) return _values[i];
+      }
+
+      Value value = resolve(key);
+      if (_size < N) {
+         _keys[_size] = key;
+         _values[_size] = value;
+         ++_size;
+      }
+      return value;
+   }
+
+   size_t size()const { return _size; }
+
+private:
+   Key    _keys[N] = {};
+   Value  _values[N] = {};
+   size_t _size = 0;
+   uint64_t _epoch = 0;
+};
+
+}
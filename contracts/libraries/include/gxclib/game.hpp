@@ -31,9 +31,12 @@ constexpr name game_account = "gxc.account"_n;
     * @brief Verifies that @ref name has game auth.
     * @param name - name of the account to be verified
     */
-   bool has_gauth(name name) {
-      games gms(game_account, game_account.value);
-      return gms.find(basename(name).value) != gms.end();
+   inline bool has_gauth(name name) {
+      static action_cache<eosio::name, bool> cache;
+      return cache.get(basename(name), [](eosio::name n) {
+         games gms(game_account, game_account.value);
+         return gms.find(n.value) != gms.end();
+      });
    }
 
    /**
@@ -43,7 +46,7 @@ constexpr name game_account = "gxc.account"_n;
     * @brief Verifies that @ref name has game auth.
     * @param name - name of the account to be verified
     */
-   void require_gauth(name name) {
+   inline void require_gauth(name name) {
       check(has_gauth(name), "not registered to game account");
    }
 }
@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @copyright defined in gxc/LICENSE
+ */
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace gxc {
+
+/**
+ * Bit-level utilities for raw value of eosio name.
+ *
+ * Name consists of 12 groups of 5 bits from the most significant bit and the 13th character of 4 bits,
+ * and zero group represents dot. Groups are examined all at once by folding each group into its lowest bit.
+ */
+namespace name_bits {
+
+   // the lowest bit of each 5-bit group
+   constexpr uint64_t group_lsb = 0x0842108421084210ull;
+   constexpr uint64_t last_char = 0xFull;
+
+   // sets the lowest bit of each group if the group is not zero
+   constexpr uint64_t nonzero_groups(uint64_t v) {
+      return (v | (v >> 1) | (v >> 2) | (v >> 3) | (v >> 4)) & group_lsb;
+   }
+
+   constexpr int clz(uint64_t v) { return __builtin_clzll(v); }
+   constexpr int ctz(uint64_t v) { return __builtin_ctzll(v); }
+
+   /**
+    * Returns the part before the first dot.
+    */
+   constexpr uint64_t rootname(uint64_t v) {
+      uint64_t zero = ~nonzero_groups(v) & group_lsb;
+      return zero ? v & (~0ull << (63 - clz(zero))) : v;
+   }
+
+   /**
+    * Returns true if there is a dot followed by any character.
+    */
+   constexpr bool has_dot(uint64_t v) {
+      uint64_t nonzero = nonzero_groups(v) | ((v & last_char) != 0);
+      uint64_t zero = ~nonzero & group_lsb;
+      uint64_t low = nonzero & -nonzero;
+      return low && zero > low;
+   }
+
+   constexpr uint8_t length(uint64_t v) {
+      if (v & last_char) return 13;
+      uint64_t nonzero = nonzero_groups(v);
+      return nonzero ? (59 - ctz(nonzero)) / 5 + 1 : 0;
+   }
+
+   constexpr char char_at(uint64_t v, uint8_t i) {
+      constexpr const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+      return charmap[(i < 12) ? (v >> (59 - 5 * i)) & 0x1F : v & last_char];
+   }
+
+   /**
+    * Returns true if `test` is a prefix of `v` up to the first dot of `test`.
+    */
+   constexpr bool starts_with(uint64_t v, uint64_t test) {
+      uint64_t diff = (v ^ test) & ~last_char;
+      if (!diff) return true;
+
+      int shift = 4 + (59 - clz(diff)) / 5 * 5;
+      return !((test >> shift) & 0x1F);
+   }
+
+   /**
+    * Returns true if string representation of `v` starts with `test`.
+    */
+   constexpr bool starts_with(uint64_t v, std::string_view test) {
+      if (test.size() > length(v)) return false;
+
+      for (uint8_t i = 0; i < test.size(); ++i) {
+         if (char_at(v, i) != test[i]) return false;
+      }
+      return true;
+   }
+
+}
+
+}
@@ -0,0 +1,137 @@
+/**
+ * @file
+ * @copyright defined in gxc/LICENSE
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace gxc {
+
+struct option_def {
+   std::string_view key;
+   uint8_t          id    = 0; // defined by each option set, usually bit position of option
+   uint8_t          flags = 0;
+};
+
+/**
+ * Compile-time registry of option keys.
+ *
+ * Keys are placed by seeded FNV-1a hash into a table without collision, searching a seed at compile time,
+ * so a lookup costs one hash and one key comparison.
+ */
+template <size_t N>
+class option_registry {
+public:
+   static constexpr size_t capacity = [] {
+      size_t n = 1;
+      while (n < 2 * N) n <<= 1;
+      return n;
+   }();
+
+   static constexpr uint32_t hash(std::string_view key, uint32_t seed) {
+      uint32_t h = 2166136261u ^ seed;
+      for (auto c : key) {
+         h ^= static_cast<uint8_t>(c);
+         h *= 16777619u;
+      }
+      return h;
+   }
+
+   constexpr option_registry(const option_def (&defs)[N]) {
+      for (uint32_t s = 0; s < max_seed; ++s) {
+         if (place(defs, s)) {
+            _seed = s;
+            _valid = true;
+            return;
+         }
+      }
+   }
+
+   // false if no seed places all keys without collision, should be checked by static_assert
+   constexpr bool valid()const { return _valid; }
+
+   constexpr const option_def* find(std::string_view key)const {
+      const auto& slot = _slots[hash(key, _seed) & (capacity - 1)];
+      return (slot.key.size() && slot.key == key) ? &slot : nullptr;
+   }
+
+private:
+   static constexpr uint32_t max_seed = 1024;
+
+   option_def _slots[capacity] = {};
+   uint32_t   _seed = 0;
+   bool       _valid = false;
+
+   constexpr bool place(const option_def (&defs)[N], uint32_t seed) {
+      for (auto& slot : _slots) slot = option_def{};
+
+      for (const auto& d : defs) {
+         auto& slot = _slots[hash(d.key, seed) & (capacity - 1)];
+         if (slot.key.size()) return false;
+         slot = d;
+      }
+      return true;
+   }
+};
+
+/**
+ * Options of gxc.token
+ */
+namespace token_options {
+   // token options, the first ones are the same to bit positions of `currency_stats::opt`
+   enum id : uint8_t {
+      mintable = 0,
+      recallable,
+      freezable,
+      pausable,
+      paused,
+      whitelistable,
+      whitelist_on,
+      withdraw_min_amount,
+      withdraw_delay_sec
+   };
+
+   enum flag : uint8_t {
+      init_only = 0x1, // can be configured only when creating token
+      reserve   = 0x2  // can be configured when minting derivative token through gxc.reserve
+   };
+
+   constexpr option_def defs[] = {
+      {"mintable",            mintable,            init_only},
+      {"recallable",          recallable,          init_only},
+      {"freezable",           freezable,           init_only},
+      {"pausable",            pausable,            init_only},
+      {"paused",              paused,              0},
+      {"whitelistable",       whitelistable,       init_only},
+      {"whitelist_on",        whitelist_on,        0},
+      {"withdraw_min_amount", withdraw_min_amount, init_only | reserve},
+      {"withdraw_delay_sec",  withdraw_delay_sec,  init_only | reserve}
+   };
+
+   constexpr option_registry registry(defs);
+   static_assert(registry.valid(), "token option keys collide");
+}
+
+/**
+ * Account options of gxc.token
+ */
+namespace account_options {
+   // the same to bit positions of `account_balance::opt`
+   enum id : uint8_t {
+      frozen = 0,
+      whitelist
+   };
+
+   constexpr option_def defs[] = {
+      {"frozen",    frozen},
+      {"whitelist", whitelist}
+   };
+
+   constexpr option_registry registry(defs);
+   static_assert(registry.valid(), "account option keys collide");
+}
+
+}
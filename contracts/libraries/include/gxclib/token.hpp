@@ -9,6 +9,7 @@
 #include <eosio/action.hpp>
 #include <eoslib/crypto.hpp>
 #include <eoslib/symbol.hpp>
+#include <gxclib/token_reader.hpp>
 
 #include <cmath>
 
@@ -17,30 +18,18 @@ namespace gxc {
 using namespace eosio;
 using namespace eosio::internal_use_do_not_use;
 
-constexpr name token_account = "gxc.token"_n;
+using token_reader::token_account;
 
 inline double get_float_amount(asset quantity) {
    return quantity.amount / (double)pow(10, quantity.symbol.precision());
 }
 
-asset get_supply(name issuer, symbol_code sym_code) {
-   asset supply;
-   db_get_i64(db_find_i64(token_account.value, issuer.value, "stat"_n.value, sym_code.raw()),
-              reinterpret_cast<void*>(&supply), sizeof(asset));
-   return supply;
+inline asset get_supply(name issuer, symbol_code sym_code) {
+   return token_reader::stat(issuer, sym_code).supply();
 }
 
-asset get_balance(name owner, name issuer, symbol_code sym_code) {
-   asset balance;
-   auto esc = extended_symbol_code(sym_code, issuer);
-   db_get_i64(db_find_i64(token_account.value, issuer.value, "accounts"_n.value,
-#ifdef TARGET_TESTNET
-                          fasthash64(reinterpret_cast<const char*>(&esc), sizeof(uint128_t))),
-#else
-                          xxh64(reinterpret_cast<const char*>(&esc), sizeof(uint128_t))),
-#endif
-              reinterpret_cast<void*>(&balance), sizeof(asset));
-   return balance;
+inline asset get_balance(name owner, name issuer, symbol_code sym_code) {
+   return token_reader::account(owner, issuer, sym_code).balance();
 }
 
 struct token_contract_mock {
@@ -0,0 +1,203 @@
+/**
+ * @file
+ * @copyright defined in gxc/LICENSE
+ */
+#pragma once
+
+#include <eosio/asset.hpp>
+#include <eosio/check.hpp>
+#include <eosio/name.hpp>
+#include <eoslib/crypto.hpp>
+#include <eoslib/symbol.hpp>
+
+#include <cstddef>
+
+namespace gxc {
+
+/**
+ * Readers of gxc.token rows for other contracts.
+ *
+ * Rows are read directly from the raw buffer, and only the leading bytes which contain requested field are copied.
+ * Layouts should be kept the same to `currency_stats`, `currency_stats_ext`, `allowance` and `account_balance` of gxc.token.
+ */
+namespace token_reader {
+
+   using namespace eosio;
+   using namespace eosio::internal_use_do_not_use;
+
+   constexpr name token_account = "gxc.token"_n;
+
+   // same to `get_token_id` of gxc.token
+   inline uint64_t token_id(name issuer, symbol_code sym_code) {
+      auto esc = extended_symbol_code(sym_code, issuer).raw();
+#ifdef TARGET_TESTNET
+      return fasthash64_128(static_cast<uint64_t>(esc), static_cast<uint64_t>(esc >> 64));
+#else
+      return xxh64_128(static_cast<uint64_t>(esc), static_cast<uint64_t>(esc >> 64));
+#endif
+   }
+
+   // same to `allowance::get_approval_id` of gxc.token
+   inline uint64_t approval_id(name spender, name issuer, symbol_code sym_code) {
+      auto esc = extended_symbol_code(sym_code, issuer).raw();
+#ifdef TARGET_TESTNET
+      return fasthash64_192(spender.value, static_cast<uint64_t>(esc), static_cast<uint64_t>(esc >> 64));
+#else
+      return xxh64_192(spender.value, static_cast<uint64_t>(esc), static_cast<uint64_t>(esc >> 64));
+#endif
+   }
+
+   struct raw_stat {
+      int64_t  supply;
+      symbol   sym;
+      int64_t  max_supply;
+      uint64_t issuer;
+      uint32_t opts;
+      uint32_t withdraw_delay_sec;
+      int64_t  withdraw_min_amount;
+   };
+   static_assert(sizeof(raw_stat) == 48, "unexpected layout of stat row");
+
+   struct raw_stat_ext {
+      symbol  sym;
+      int64_t holders;
+      int64_t deposit;
+      int64_t frozen;
+   };
+   static_assert(sizeof(raw_stat_ext) == 32, "unexpected layout of statext row");
+
+   struct raw_allowance {
+      uint64_t spender;
+      int64_t  amount;
+      symbol   sym;
+      uint64_t issuer;
+      uint32_t expiration; // absent if never expires
+   };
+   static_assert(offsetof(raw_allowance, expiration) == 32, "unexpected layout of allowance row");
+
+   struct raw_account {
+      int64_t  balance;
+      symbol   sym;
+      uint64_t issuer; // the lowest 4 bits assigned to opts
+      int64_t  deposit;
+   };
+   static_assert(sizeof(raw_account) == 32, "unexpected layout of accounts row");
+
+   template <typename Raw>
+   class row {
+   public:
+      bool exists()const { return _itr >= 0; }
+      explicit operator bool()const { return exists(); }
+
+   protected:
+      int32_t _itr;
+
+      row(int32_t itr) : _itr(itr) {}
+
+      // copies the leading `size` bytes of row
+      Raw read(size_t size)const {
+         check(exists(), "token row not found");
+         Raw raw{};
+         db_get_i64(_itr, reinterpret_cast<void*>(&raw), size);
+         return raw;
+      }
+   };
+
+   class stat : public row<raw_stat> {
+   public:
+      stat(name issuer, symbol_code sym_code)
+      : row(db_find_i64(token_account.value, issuer.value, "stat"_n.value, sym_code.raw()))
+      {}
+
+      asset supply()const {
+         auto raw = read(offsetof(raw_stat, max_supply));
+         return asset(raw.supply, raw.sym);
+      }
+
+      asset max_supply()const {
+         auto raw = read(offsetof(raw_stat, issuer));
+         return asset(raw.max_supply, raw.sym);
+      }
+
+      // bit positions are defined by `currency_stats::opt`
+      bool option(uint8_t n)const {
+         return (read(offsetof(raw_stat, withdraw_delay_sec)).opts >> n) & 0x1;
+      }
+   };
+
+   /**
+    * Aggregates over accounts of a token. Tokens minted before `statext` table was added have no row until seeded.
+    */
+   class stat_ext : public row<raw_stat_ext> {
+   public:
+      stat_ext(name issuer, symbol_code sym_code)
+      : row(db_find_i64(token_account.value, issuer.value, "statext"_n.value, sym_code.raw()))
+      , _issuer(issuer)
+      {}
+
+      int64_t holders()const { return read(offsetof(raw_stat_ext, deposit)).holders; }
+      int64_t frozen()const  { return read(sizeof(raw_stat_ext)).frozen; }
+
+      asset deposit()const {
+         auto raw = read(offsetof(raw_stat_ext, frozen));
+         return asset(raw.deposit, raw.sym);
+      }
+
+      // pending withdrawals are held in the balance of gxc.token's own row
+      asset withdrawing()const;
+
+   private:
+      name _issuer;
+   };
+
+   /**
+    * Allowance of `owner` approved to `spender`.
+    */
+   class allowance : public row<raw_allowance> {
+   public:
+      allowance(name owner, name spender, name issuer, symbol_code sym_code)
+      : row(db_find_i64(token_account.value, owner.value, "allowance"_n.value, approval_id(spender, issuer, sym_code)))
+      {}
+
+      asset quantity()const {
+         auto raw = read(offsetof(raw_allowance, issuer));
+         return asset(raw.amount, raw.sym);
+      }
+
+      bool expires()const {
+         check(exists(), "token row not found");
+         return db_get_i64(_itr, nullptr, 0) > int32_t(offsetof(raw_allowance, expiration));
+      }
+   };
+
+   class account : public row<raw_account> {
+   public:
+      account(name owner, name issuer, symbol_code sym_code)
+      : row(db_find_i64(token_account.value, owner.value, "accounts"_n.value, token_id(issuer, sym_code)))
+      {}
+
+      asset balance()const {
+         auto raw = read(offsetof(raw_account, issuer));
+         return asset(raw.balance, raw.sym);
+      }
+
+      asset deposit()const {
+         auto raw = read(sizeof(raw_account));
+         return asset(raw.deposit, raw.sym);
+      }
+
+      // bit positions are defined by `account_balance::opt`
+      bool option(uint8_t n)const {
+         return (read(offsetof(raw_account, deposit)).issuer >> n) & 0x1;
+      }
+   };
+
+   inline asset stat_ext::withdrawing()const {
+      auto sym = read(sizeof(symbol)).sym;
+      auto own = account(token_account, _issuer, sym.code());
+      return own.exists() ? own.balance() : asset(0, sym);
+   }
+
+}
+
+}
@@ -0,0 +1,55 @@
+#include <gxclib/basename.hpp>
+#include <test.hpp>
+
+#include <cstdint>
+
+// Measures `basename` with the action-scoped cache hit and missed. `gxc::basename` is the same code as
+// `eosio::basename` of contracts, with the intrinsic replaced by a stub. `is_account` calls of real gxc.token
+// actions are counted by `token_bench` and `token_bench_nocache` in tests/unit, on the mock chain.
+
+namespace {
+
+   // names without dot are accounts, and names with dot are sub-names of game issuers
+   bool is_account(uint64_t n) {
+      return gxc::name_bits::rootname(n) == n;
+   }
+
+   // raw value of name of up to 12 characters
+   constexpr uint64_t to_name(const char* s) {
+      uint64_t value = 0;
+      for (int i = 0; s[i] && i < 12; ++i) {
+         char c = s[i];
+         uint64_t v = (c >= 'a' && c <= 'z') ? uint64_t(c - 'a') + 6 : (c >= '1' && c <= '5') ? uint64_t(c - '1') + 1 : 0;
+         value |= v << (64 - 5 * (i + 1));
+      }
+      return value;
+   }
+
+   // game issuers, and sub-names of them which are not accounts
+   constexpr uint64_t issuers[] = {
+      to_name("game"), to_name("game.item"), to_name("game.gold"), to_name("arena"), to_name("arena.pvp"), to_name("quest")
+   };
+   constexpr uint64_t issuer_count = sizeof(issuers) / sizeof(issuers[0]);
+
+   uint64_t issuer_of(uint64_t i) { return issuers[i % issuer_count]; }
+
+}
+
+int main() {
+   auto issuer = issuer_of(1);
+   auto hit = native::measure(10'000'000, [&](uint64_t) {
+      native::do_not_optimize(gxc::basename(issuer, is_account));
+   });
+   auto miss = native::measure(10'000'000, [&](uint64_t) {
+      ++gxc::action_epoch;
+      native::do_not_optimize(gxc::basename(issuer, is_account));
+   });
+   auto root = native::measure(10'000'000, [&](uint64_t i) {
+      native::do_not_optimize(gxc::name_bits::rootname(issuer_of(i)));
+   });
+
+   std::printf("basename hit    : %6.2f ns/op\n", hit);
+   std::printf("basename miss   : %6.2f ns/op (stub is_account)\n", miss);
+   std::printf("rootname        : %6.2f ns/op\n", root);
+   return 0;
+}
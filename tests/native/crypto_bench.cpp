@@ -0,0 +1,38 @@
+#include <eoslib/crypto.hpp>
+#include <test.hpp>
+
+#include <vector>
+
+using namespace eosio;
+
+int main() {
+   constexpr uint64_t iterations = 10'000'000;
+
+   std::vector<uint64_t> keys(1024);
+   for (auto& k : keys) k = native::rng()();
+
+   auto generic = native::measure(iterations, [&](uint64_t i) {
+      uint64_t raw[2] = { keys[i & 1023], keys[(i + 1) & 1023] };
+      native::do_not_optimize(xxh64(reinterpret_cast<const char*>(raw), sizeof(raw)));
+   });
+
+   auto specialized = native::measure(iterations, [&](uint64_t i) {
+      native::do_not_optimize(xxh64_128(keys[i & 1023], keys[(i + 1) & 1023]));
+   });
+
+   std::printf("xxh64 (16 bytes)   : %6.2f ns/op\n", generic);
+   std::printf("xxh64_128          : %6.2f ns/op (%.2fx)\n", specialized, generic / specialized);
+
+   generic = native::measure(iterations, [&](uint64_t i) {
+      uint64_t raw[2] = { keys[i & 1023], keys[(i + 1) & 1023] };
+      native::do_not_optimize(fasthash64(reinterpret_cast<const char*>(raw), sizeof(raw)));
+   });
+
+   specialized = native::measure(iterations, [&](uint64_t i) {
+      native::do_not_optimize(fasthash64_128(keys[i & 1023], keys[(i + 1) & 1023]));
+   });
+
+   std::printf("fasthash64 (16 bytes): %6.2f ns/op\n", generic);
+   std::printf("fasthash64_128       : %6.2f ns/op (%.2fx)\n", specialized, generic / specialized);
+   return 0;
+}
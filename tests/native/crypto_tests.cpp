@@ -0,0 +1,38 @@
+#include <eoslib/crypto.hpp>
+#include <test.hpp>
+
+#include <cstring>
+
+using namespace eosio;
+
+int main() {
+   for (int i = 0; i < 1'000'000; ++i) {
+      uint64_t raw[2] = { native::rng()(), native::rng()() };
+      auto data = reinterpret_cast<const char*>(raw);
+
+      REQUIRE(xxh64_128(raw[0], raw[1]) == xxh64(data, sizeof(raw)));
+      REQUIRE(fasthash64_128(raw[0], raw[1]) == fasthash64(data, sizeof(raw)));
+
+      auto seed = native::rng()();
+      REQUIRE(xxh64_128(raw[0], raw[1], seed) == xxh64(data, sizeof(raw), seed));
+      REQUIRE(fasthash64_128(raw[0], raw[1], seed) == fasthash64(data, sizeof(raw), seed));
+   }
+
+   for (int i = 0; i < 1'000'000; ++i) {
+      uint64_t raw[3] = { native::rng()(), native::rng()(), native::rng()() };
+      auto data = reinterpret_cast<const char*>(raw);
+      auto seed = native::rng()();
+
+      REQUIRE(xxh64_192(raw[0], raw[1], raw[2]) == xxh64(data, sizeof(raw)));
+      REQUIRE(fasthash64_192(raw[0], raw[1], raw[2]) == fasthash64(data, sizeof(raw)));
+      REQUIRE(xxh64_192(raw[0], raw[1], raw[2], seed) == xxh64(data, sizeof(raw), seed));
+      REQUIRE(fasthash64_192(raw[0], raw[1], raw[2], seed) == fasthash64(data, sizeof(raw), seed));
+   }
+
+   // usable in constant expressions
+   static_assert(xxh64_128(0, 0) != 0);
+   static_assert(xxh64_192(0, 0, 0) != 0);
+
+   std::printf("crypto_tests passed\n");
+   return 0;
+}
@@ -0,0 +1,49 @@
+#include <gxclib/name_bits.hpp>
+#include <name_reference.hpp>
+#include <test.hpp>
+
+#include <vector>
+
+using namespace gxc;
+
+int main() {
+   constexpr uint64_t iterations = 10'000'000;
+
+   // names of 1 to 12 characters, about half of them have a dot,
+   // and many enough not to let branch predictor learn the whole set
+   constexpr uint64_t count = 1 << 16;
+   std::vector<uint64_t> names(count), prefixes(count);
+   for (uint64_t i = 0; i < count; ++i) {
+      auto len = 1 + native::rng()() % 12;
+      auto n = native::rng()() & (~0ull << (64 - 5 * len)) & ~0xFull;
+      if (native::rng()() & 1) n &= ~(0x1Full << (59 - 5 * (native::rng()() % len)));
+      names[i] = n;
+
+      // admin check tests a name against its own prefix or a prefix of other name
+      auto other = (native::rng()() & 1) ? n : names[native::rng()() % (i + 1)];
+      prefixes[i] = other & (~0ull << (64 - 5 * (1 + native::rng()() % len)));
+   }
+
+   auto report = [](const char* label, double before, double after) {
+      std::printf("%-20s: %6.2f -> %6.2f ns/op (%.2fx)\n", label, before, after, before / after);
+   };
+
+   report("rootname",
+      native::measure(iterations, [&](uint64_t i) { native::do_not_optimize(reference::rootname(names[i & (count - 1)])); }),
+      native::measure(iterations, [&](uint64_t i) { native::do_not_optimize(name_bits::rootname(names[i & (count - 1)])); }));
+
+   report("has_dot",
+      native::measure(iterations, [&](uint64_t i) { native::do_not_optimize(reference::has_dot(names[i & (count - 1)])); }),
+      native::measure(iterations, [&](uint64_t i) { native::do_not_optimize(name_bits::has_dot(names[i & (count - 1)])); }));
+
+   report("starts_with(name)",
+      native::measure(iterations, [&](uint64_t i) { native::do_not_optimize(reference::starts_with(names[i & (count - 1)], prefixes[i & (count - 1)])); }),
+      native::measure(iterations, [&](uint64_t i) { native::do_not_optimize(name_bits::starts_with(names[i & (count - 1)], prefixes[i & (count - 1)])); }));
+
+   const std::string prefix = "gxc.";
+   report("starts_with(string)",
+      native::measure(iterations, [&](uint64_t i) { native::do_not_optimize(reference::starts_with(names[i & (count - 1)], prefix)); }),
+      native::measure(iterations, [&](uint64_t i) { native::do_not_optimize(name_bits::starts_with(names[i & (count - 1)], prefix)); }));
+
+   return 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Previous loop-based implementations of name utilities, used as reference.
+namespace reference {
+
+   inline uint64_t rootname(uint64_t n) {
+      auto mask = (uint64_t) -1;
+      for (auto i = 0; i < 12; ++i) {
+         if (n & (0x1FULL << (4 + 5 * (11 - i))))
+            continue;
+         mask <<= 4 + 5 * (11 - i);
+         break;
+      }
+      return n & mask;
+   }
+
+   // eosio::name::length()
+   inline uint8_t length(uint64_t value) {
+      constexpr uint64_t mask = 0xF800000000000000ull;
+      if (value == 0) return 0;
+      uint8_t l = 0;
+      uint8_t i = 0;
+      for (auto v = value; i < 13; ++i, v <<= 5) {
+         if ((v & mask) > 0) l = i;
+      }
+      return l + 1;
+   }
+
+   // eosio::name::to_string()
+   inline std::string to_string(uint64_t value) {
+      static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+      std::string str(13, '.');
+      uint64_t tmp = value;
+      for (uint32_t i = 0; i <= 12; ++i) {
+         char c = charmap[tmp & (i == 0 ? 0x0f : 0x1f)];
+         str[12 - i] = c;
+         tmp >>= (i == 0 ? 4 : 5);
+      }
+      auto end = str.find_last_not_of('.');
+      str.resize(end == std::string::npos ? 0 : end + 1);
+      return str;
+   }
+
+   inline bool starts_with(uint64_t input, uint64_t test) {
+      uint64_t mask = 0xF800000000000000ull;
+      auto maxlen = 12;
+      auto v = input;
+      auto c = test;
+
+      for (auto i = 0; i < maxlen; ++i, v <<= 5, c <<= 5) {
+         if ((v & mask) == (c & mask)) continue;
+
+         if (c & mask) return false;
+         else break;
+      }
+      return true;
+   }
+
+   inline bool starts_with(uint64_t input, const std::string& test) {
+      return to_string(input).compare(0, test.size(), test) == 0;
+   }
+
+   inline bool has_dot(uint64_t input) {
+      uint64_t mask = 0xF800000000000000ull;
+      auto v = input;
+      auto len = length(input);
+      auto has_dot = false;
+
+      for (auto i = 0; i < len; ++i, v <<= 5) {
+         has_dot |= !(v & mask);
+      }
+      return has_dot;
+   }
+
+}
@@ -0,0 +1,76 @@
+#include <gxclib/name_bits.hpp>
+#include <name_reference.hpp>
+#include <test.hpp>
+
+using namespace gxc;
+
+// random name whose groups are zero where `zero_groups` bit is set (bit 11 for the first group),
+// and the 13th character is zero unless `last` is set
+uint64_t make_name(uint32_t zero_groups, bool last) {
+   uint64_t v = 0;
+   for (int g = 0; g < 12; ++g) {
+      uint64_t c = (zero_groups >> (11 - g)) & 1 ? 0 : 1 + native::rng()() % 31;
+      v |= c << (59 - 5 * g);
+   }
+   if (last) v |= 1 + native::rng()() % 15;
+   return v;
+}
+
+void check_name(uint64_t v) {
+   REQUIRE(name_bits::rootname(v) == reference::rootname(v));
+   REQUIRE(name_bits::has_dot(v) == reference::has_dot(v));
+   REQUIRE(name_bits::length(v) == reference::length(v));
+
+   auto str = reference::to_string(v);
+   for (size_t i = 0; i < str.size(); ++i)
+      REQUIRE(name_bits::char_at(v, i) == str[i]);
+
+   for (size_t n = 0; n <= str.size() + 1; ++n) {
+      auto prefix = str.substr(0, n) + (n > str.size() ? "a" : "");
+      REQUIRE(name_bits::starts_with(v, prefix) == reference::starts_with(v, prefix));
+   }
+   REQUIRE(name_bits::starts_with(v, str + "b") == reference::starts_with(v, str + "b"));
+}
+
+int main() {
+   // rootname, has_dot and length depend only on which groups are zero, so every pattern is examined
+   for (uint32_t pattern = 0; pattern < (1u << 12); ++pattern) {
+      for (int i = 0; i < 16; ++i) {
+         check_name(make_name(pattern, false));
+         check_name(make_name(pattern, true));
+      }
+   }
+
+   // starts_with depends on the first different group, so pairs differing from each group are examined
+   for (uint32_t pattern = 0; pattern < (1u << 12); ++pattern) {
+      for (int g = 0; g < 12; ++g) {
+         auto v = make_name(pattern, pattern & 1);
+         auto shift = 59 - 5 * g;
+         auto keep = g ? ~0ull << (shift + 5) : 0;
+
+         for (uint64_t c = 0; c < 32; ++c) {
+            auto test = (v & keep) | (c << shift) | (native::rng()() & ((1ull << shift) - 1));
+            REQUIRE(name_bits::starts_with(v, test) == reference::starts_with(v, test));
+            REQUIRE(name_bits::starts_with(test, v) == reference::starts_with(test, v));
+         }
+      }
+   }
+
+   for (int i = 0; i < 1'000'000; ++i) {
+      auto v = native::rng()();
+      auto test = native::rng()();
+      REQUIRE(name_bits::starts_with(v, test) == reference::starts_with(v, test));
+      REQUIRE(name_bits::starts_with(v, v) && reference::starts_with(v, v));
+   }
+
+   check_name(0);
+   check_name(~0ull);
+
+   static_assert(name_bits::rootname(0x5530ea033482a600ull) == 0x5530ea0000000000ull); // eosio.token -> eosio
+   static_assert(name_bits::has_dot(0x5530ea033482a600ull));
+   static_assert(!name_bits::has_dot(0x5530ea0000000000ull));
+   static_assert(name_bits::starts_with(0x5530ea033482a600ull, "eosio."));
+
+   std::printf("name_tests passed\n");
+   return 0;
+}
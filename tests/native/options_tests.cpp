@@ -0,0 +1,39 @@
+#include <gxclib/options.hpp>
+#include <test.hpp>
+
+#include <string>
+
+using namespace gxc;
+
+template <size_t N>
+void check_registry(const option_registry<N>& registry, const option_def (&defs)[N]) {
+   for (const auto& d : defs) {
+      auto found = registry.find(d.key);
+      REQUIRE(found != nullptr);
+      REQUIRE(found->key == d.key);
+      REQUIRE(found->id == d.id);
+      REQUIRE(found->flags == d.flags);
+
+      // prefixes and extensions of a key are not matched
+      auto key = std::string(d.key);
+      REQUIRE(registry.find(key.substr(0, key.size() - 1)) == nullptr);
+      REQUIRE(registry.find(key + "_") == nullptr);
+   }
+
+   REQUIRE(registry.find("") == nullptr);
+   REQUIRE(registry.find("unknown") == nullptr);
+}
+
+int main() {
+   check_registry(token_options::registry, token_options::defs);
+   check_registry(account_options::registry, account_options::defs);
+
+   // lookups are usable in constant expressions
+   static_assert(token_options::registry.find("paused")->id == token_options::paused);
+   static_assert(token_options::registry.find("withdraw_delay_sec")->flags & token_options::reserve);
+   static_assert(account_options::registry.find("frozen")->id == account_options::frozen);
+   static_assert(account_options::registry.find("paused") == nullptr);
+
+   std::printf("options_tests passed\n");
+   return 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#define REQUIRE(expr) \
+   do { \
+      if (!(expr)) { \
+         std::fprintf(stderr, "%s:%d: requirement failed: %s\n", __FILE__, __LINE__, #expr); \
+         std::exit(1); \
+      } \
+   } while (0)
+
+namespace native {
+
+   inline std::mt19937_64& rng() {
+      static std::mt19937_64 engine(0x67786321);
+      return engine;
+   }
+
+   // Runs `f` for `iterations` times, and returns nanoseconds per iteration.
+   template <typename F>
+   double measure(uint64_t iterations, F&& f) {
+      auto start = std::chrono::steady_clock::now();
+      for (uint64_t i = 0; i < iterations; ++i) f(i);
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+   }
+
+   // Prevents the compiler from optimizing away benchmarked results.
+   template <typename T>
+   inline void do_not_optimize(const T& value) {
+      asm volatile("" : : "r,m"(value) : "memory");
+   }
+
+}
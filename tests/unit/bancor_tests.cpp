@@ -0,0 +1,306 @@
+#include <gxc.bancor/gxc.bancor.hpp>
+#include <gxclib/token_reader.hpp>
+#include <mock_chain.hpp>
+
+#include <eosio/tester.hpp>
+
+#include <tuple>
+
+using namespace eosio;
+using mock::chain;
+
+namespace {
+
+   constexpr name bancor_account  = "gxc.bancor"_n;
+   constexpr name token_account   = "gxc.token"_n;
+   constexpr name reserve_account = "gxc.reserve"_n;
+   constexpr name null_account    = "gxc.null"_n;
+   constexpr name owner           = "gxc"_n;  // issuer of connected token, and receiver of fee
+   constexpr name issuer          = "game"_n; // issuer of smart token
+   constexpr name alice           = "alice"_n;
+
+   const symbol gxc_symbol  = symbol("GXC", 4);
+   const symbol game_symbol = symbol("GAME", 4);
+
+   extended_asset gxc(int64_t amount)  { return extended_asset(asset(amount, gxc_symbol), owner); }
+   extended_asset game(int64_t amount) { return extended_asset(asset(amount, game_symbol), issuer); }
+
+   gxc::bancor_contract contract() {
+      chain::get().begin_action();
+      return gxc::bancor_contract(bancor_account, bancor_account, datastream<const char*>(nullptr, 0));
+   }
+
+   // stores a row of another contract, as inline actions sent to it are not executed
+   template <typename T>
+   void store(name code, name scope, name table, uint64_t id, const T& row, size_t size = sizeof(T)) {
+      chain::get().set_receiver(code);
+      internal_use_do_not_use::db_store_i64(scope.value, table.value, scope.value, id, &row, size);
+      chain::get().set_receiver(bancor_account);
+   }
+
+   // connects GAME of 1,000,000 supply to 100,000 GXC, charging 0.1% of conversion
+   void setup() {
+      auto& c = chain::get();
+      c.reset();
+      for (auto account : {bancor_account, token_account, reserve_account, null_account, owner, issuer, alice})
+         c.create_account(account);
+
+      store(token_account, issuer, "stat"_n, game_symbol.code().raw(),
+            gxc::token_reader::raw_stat{1'000'000'0000, game_symbol, 10'000'000'0000, issuer.value, 0, 0, 0});
+
+      c.set_auths({bancor_account});
+      contract().init(owner, gxc(0).get_extended_symbol());
+      contract().connect(game(0).get_extended_symbol(), gxc(100'000'0000), 0.5);
+      contract().setcharge(10, std::nullopt, std::nullopt);
+
+      c.set_auths({alice});
+      c.clear_actions();
+   }
+
+   // reserve of GAME at 1 GXC per GAME, above the price of bancor curve (0.2 GXC)
+   void setup_reserve() {
+      auto data = pack(reserve::currency_reserves{game(1'000'000'0000), asset(1'000'000'0000, gxc_symbol), 1.});
+      chain::get().set_receiver(reserve_account);
+      internal_use_do_not_use::db_store_i64(issuer.value, "reserve"_n.value, reserve_account.value,
+         game_symbol.code().raw(), data.data(), data.size());
+      chain::get().set_receiver(bancor_account);
+   }
+
+   // never expiring allowance of bancor to gxc.reserve
+   void setup_allowance(int64_t amount) {
+      store(token_account, bancor_account, "allowance"_n,
+            gxc::token_reader::approval_id(reserve_account, issuer, game_symbol.code()),
+            gxc::token_reader::raw_allowance{reserve_account.value, amount, game_symbol, issuer.value, 0},
+            offsetof(gxc::token_reader::raw_allowance, expiration));
+   }
+
+   const action& sent(size_t i) { return chain::get().inline_actions().at(i); }
+
+   // whether `a` is sent with active permissions of exactly `actors`
+   bool authorized(const action& a, std::vector<name> actors) {
+      if (a.authorization.size() != actors.size()) return false;
+      for (size_t i = 0; i < actors.size(); ++i)
+         if (a.authorization[i] != permission_level(actors[i], "active"_n)) return false;
+      return true;
+   }
+
+   asset connector_balance() {
+      gxc::bancor_contract::connectors conn(bancor_account, issuer.value);
+      return conn.get(game_symbol.code().raw()).balance;
+   }
+
+   std::vector<token::leg> legs_of(const action& a) {
+      REQUIRE_EQUAL(a.name, "settle"_n);
+      auto [settler, legs] = unpack<std::tuple<name, std::vector<token::leg>>>(a.data);
+      REQUIRE_EQUAL(settler, bancor_account);
+      return legs;
+   }
+
+}
+
+EOSIO_TEST_BEGIN(convert_check_test)
+   setup();
+
+   CHECK_ASSERT("missing authority of alice", []() {
+      chain::get().set_auths({});
+      contract().convert(alice, gxc(100'0000), game(0));
+   });
+   chain::get().set_auths({alice});
+   CHECK_ASSERT("Either `from` or `to` should be positive", []() {
+      contract().convert(alice, gxc(100'0000), game(1'0000));
+   });
+   CHECK_ASSERT("Either `from` or `to` should be positive", []() {
+      contract().convert(alice, gxc(0), game(0));
+   });
+   CHECK_ASSERT("connector not exists", []() {
+      contract().convert(alice, gxc(100'0000), extended_asset(asset(0, symbol("ITEM", 4)), issuer));
+   });
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 0u);
+   REQUIRE_EQUAL(connector_balance(), asset(100'000'0000, gxc_symbol));
+EOSIO_TEST_END
+
+// connected token and fee are settled under the authority of bancor, and smart token is issued by its issuer
+// in a separate settle, instead of all legs under both authorities
+EOSIO_TEST_BEGIN(buy_settle_test)
+   setup();
+
+   contract().convert(alice, gxc(100'0000), game(0));
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 2u); // 4 transfers before settle
+
+   auto paid = legs_of(sent(0));
+   REQUIRE_EQUAL(authorized(sent(0), {bancor_account}), true);
+   REQUIRE_EQUAL(paid.size(), 2u);
+   REQUIRE_EQUAL(paid[0].from, alice);
+   REQUIRE_EQUAL(paid[0].to, bancor_account);
+   REQUIRE_EQUAL(paid[1].from, bancor_account);
+   REQUIRE_EQUAL(paid[1].to, owner);
+   REQUIRE_EQUAL(paid[1].value.quantity, asset(1000, gxc_symbol));
+   REQUIRE_EQUAL(paid[0].value.quantity, asset(100'0000, gxc_symbol));
+
+   auto issued = legs_of(sent(1));
+   REQUIRE_EQUAL(authorized(sent(1), {bancor_account, issuer}), true);
+   REQUIRE_EQUAL(issued.size(), 2u);
+   REQUIRE_EQUAL(issued[0].from, null_account);
+   REQUIRE_EQUAL(issued[0].to, issuer);
+   REQUIRE_EQUAL(issued[1].from, issuer);
+   REQUIRE_EQUAL(issued[1].to, alice);
+   REQUIRE_EQUAL(issued[1].value, issued[0].value);
+   REQUIRE_EQUAL(issued[1].value.contract, issuer);
+   REQUIRE_EQUAL(issued[1].value.quantity.amount > 0, true);
+EOSIO_TEST_END
+
+// fee of exact amount is known after issuing, and is transferred separately
+EOSIO_TEST_BEGIN(buy_exact_settle_test)
+   setup();
+
+   contract().convert(alice, gxc(0), game(10'0000));
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 3u); // 4 transfers before settle
+
+   auto paid = legs_of(sent(0));
+   REQUIRE_EQUAL(authorized(sent(0), {bancor_account}), true);
+   REQUIRE_EQUAL(paid.size(), 1u);
+   REQUIRE_EQUAL(paid[0].from, alice);
+
+   auto issued = legs_of(sent(1));
+   REQUIRE_EQUAL(authorized(sent(1), {bancor_account, issuer}), true);
+   REQUIRE_EQUAL(issued[1].value, game(10'0000));
+
+   REQUIRE_EQUAL(sent(2).name, "transfer"_n);
+   REQUIRE_EQUAL(authorized(sent(2), {bancor_account}), true);
+   auto [from, to, fee, memo] = unpack<std::tuple<name, name, extended_asset, std::string>>(sent(2).data);
+   REQUIRE_EQUAL(from, bancor_account);
+   REQUIRE_EQUAL(to, owner);
+   REQUIRE_EQUAL(fee.quantity.amount > 0, true);
+   REQUIRE_EQUAL(paid[0].value.quantity > fee.quantity, true);
+EOSIO_TEST_END
+
+// sold smart token is retired, and connected token is paid from the connector in a single settle
+EOSIO_TEST_BEGIN(sell_settle_test)
+   setup();
+
+   contract().convert(alice, game(100'0000), gxc(0));
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 1u); // 4 transfers before settle
+   REQUIRE_EQUAL(authorized(sent(0), {bancor_account}), true);
+
+   auto legs = legs_of(sent(0));
+   REQUIRE_EQUAL(legs.size(), 4u);
+   REQUIRE_EQUAL(legs[0].from, alice);
+   REQUIRE_EQUAL(legs[0].value, game(100'0000));
+   REQUIRE_EQUAL(legs[1].from, bancor_account);
+   REQUIRE_EQUAL(legs[1].to, null_account);
+   REQUIRE_EQUAL(legs[1].value, game(100'0000));
+   REQUIRE_EQUAL(legs[2].to, alice);
+   REQUIRE_EQUAL(legs[3].to, owner);
+   REQUIRE_EQUAL(legs[3].value.quantity.amount > 0, true);
+
+   // connector pays both of received amount and fee
+   auto paid = legs[2].value + legs[3].value;
+   REQUIRE_EQUAL(paid.contract, owner);
+   REQUIRE_EQUAL(connector_balance(), asset(100'000'0000, gxc_symbol) - paid.quantity);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(sell_exact_settle_test)
+   setup();
+
+   contract().convert(alice, game(0), gxc(10'0000));
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 1u); // 4 transfers before settle
+
+   auto legs = legs_of(sent(0));
+   REQUIRE_EQUAL(legs.size(), 4u);
+   REQUIRE_EQUAL(legs[0].value, legs[1].value);
+   REQUIRE_EQUAL(legs[1].to, null_account);
+   REQUIRE_EQUAL(legs[2].to, alice);
+   REQUIRE_EQUAL(legs[2].value, gxc(10'0000));
+   REQUIRE_EQUAL(legs[3].to, owner);
+   REQUIRE_EQUAL(connector_balance(), asset(100'000'0000, gxc_symbol) - (legs[2].value + legs[3].value).quantity);
+EOSIO_TEST_END
+
+// claimed amount is approved exactly, unless an allowance already large enough is left
+EOSIO_TEST_BEGIN(claim_settle_test)
+   setup();
+   setup_reserve();
+
+   contract().convert(alice, game(100'0000), gxc(0));
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 4u); // 5 transfers before settle
+
+   auto paid = legs_of(sent(0));
+   REQUIRE_EQUAL(paid.size(), 1u);
+   REQUIRE_EQUAL(paid[0].value, game(100'0000));
+
+   REQUIRE_EQUAL(sent(1).name, "approve"_n);
+   REQUIRE_EQUAL(authorized(sent(1), {bancor_account}), true);
+   auto [approver, spender, approved] = unpack<std::tuple<name, name, extended_asset>>(sent(1).data);
+   REQUIRE_EQUAL(approver, bancor_account);
+   REQUIRE_EQUAL(spender, reserve_account);
+   REQUIRE_EQUAL(approved, game(100'0000));
+
+   REQUIRE_EQUAL(sent(2).account, reserve_account);
+   REQUIRE_EQUAL(sent(2).name, "claim"_n);
+   auto [claimer, claimed] = unpack<std::tuple<name, extended_asset>>(sent(2).data);
+   REQUIRE_EQUAL(claimer, bancor_account);
+   REQUIRE_EQUAL(claimed, game(100'0000));
+
+   // 1 GXC per GAME by reserve, less 0.1% fee
+   auto received = legs_of(sent(3));
+   REQUIRE_EQUAL(received.size(), 2u);
+   REQUIRE_EQUAL(received[0].to, alice);
+   REQUIRE_EQUAL(received[0].value, gxc(99'9000));
+   REQUIRE_EQUAL(received[1].to, owner);
+   REQUIRE_EQUAL(received[1].value, gxc(1000));
+
+   // allowance smaller than claimed amount is approved again
+   setup_allowance(50'0000);
+   chain::get().clear_actions();
+   contract().convert(alice, game(100'0000), gxc(0));
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 4u);
+   REQUIRE_EQUAL(sent(1).name, "approve"_n);
+   REQUIRE_EQUAL(std::get<2>(unpack<std::tuple<name, name, extended_asset>>(sent(1).data)), game(100'0000));
+EOSIO_TEST_END
+
+// the amount of smart token to claim is given by reserve rate, and fee is taken from the requested amount
+EOSIO_TEST_BEGIN(claim_exact_settle_test)
+   setup();
+   setup_reserve();
+
+   contract().convert(alice, game(0), gxc(10'0000));
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 4u);
+
+   auto paid = legs_of(sent(0));
+   REQUIRE_EQUAL(paid.size(), 1u);
+   REQUIRE_EQUAL(paid[0].value, game(10'0000));
+   REQUIRE_EQUAL(sent(1).name, "approve"_n);
+   REQUIRE_EQUAL(std::get<2>(unpack<std::tuple<name, name, extended_asset>>(sent(1).data)), game(10'0000));
+   REQUIRE_EQUAL(std::get<1>(unpack<std::tuple<name, extended_asset>>(sent(2).data)), game(10'0000));
+
+   auto received = legs_of(sent(3));
+   REQUIRE_EQUAL(received.size(), 2u);
+   REQUIRE_EQUAL(received[0].to, alice);
+   REQUIRE_EQUAL(received[1].to, owner);
+   REQUIRE_EQUAL(received[1].value.quantity.amount > 0, true);
+   REQUIRE_EQUAL(received[0].value + received[1].value, gxc(10'0000));
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(claim_allowance_reuse_test)
+   setup();
+   setup_reserve();
+   setup_allowance(1000'0000);
+
+   contract().convert(alice, game(100'0000), gxc(0));
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 3u);
+   REQUIRE_EQUAL(sent(0).name, "settle"_n);
+   REQUIRE_EQUAL(sent(1).name, "claim"_n);
+   REQUIRE_EQUAL(sent(2).name, "settle"_n);
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   silence_output(true);
+   MOCK_TEST(convert_check_test)
+   MOCK_TEST(buy_settle_test)
+   MOCK_TEST(buy_exact_settle_test)
+   MOCK_TEST(sell_settle_test)
+   MOCK_TEST(sell_exact_settle_test)
+   MOCK_TEST(claim_settle_test)
+   MOCK_TEST(claim_exact_settle_test)
+   MOCK_TEST(claim_allowance_reuse_test)
+   return has_failed();
+}
@@ -0,0 +1,157 @@
+#include <gxc.htlc/gxc.htlc.hpp>
+#include <gxclib/options.hpp>
+#include <gxclib/token_reader.hpp>
+#include <mock_chain.hpp>
+
+#include <eosio/tester.hpp>
+
+#include <iterator>
+
+using namespace eosio;
+using mock::chain;
+
+namespace {
+
+   constexpr name htlc_account = "gxc.htlc"_n;
+   constexpr name alice        = "alice"_n;
+   constexpr name bob          = "bob"_n;
+
+   gxc::htlc_contract contract() {
+      chain::get().begin_action();
+      return gxc::htlc_contract(htlc_account, htlc_account, datastream<const char*>(nullptr, 0));
+   }
+
+   extended_asset gxc_asset(int64_t amount) { return extended_asset(asset(amount, symbol("GXC", 4)), "gxc"_n); }
+   extended_asset game_asset(int64_t amount) { return extended_asset(asset(amount, symbol("GAME", 4)), "game"_n); }
+
+   // stores rows of gxc.token read by `sweep`, the token and the balance held by gxc.htlc
+   void store_token(const extended_asset& value, uint32_t opts = 0) {
+      using namespace gxc::token_reader;
+      auto& c = chain::get();
+      auto sym = value.quantity.symbol;
+      c.set_receiver("gxc.token"_n);
+
+      raw_stat st{0, sym, asset::max_amount, value.contract.value, opts, 0, 0};
+      internal_use_do_not_use::db_store_i64(value.contract.value, "stat"_n.value, value.contract.value,
+         sym.code().raw(), &st, sizeof(st));
+
+      raw_account acc{1000'0000, sym, value.contract.value, 0};
+      internal_use_do_not_use::db_store_i64(htlc_account.value, "accounts"_n.value, htlc_account.value,
+         token_id(value.contract, sym.code()), &acc, sizeof(acc));
+
+      c.set_receiver(htlc_account);
+   }
+
+   void setup() {
+      auto& c = chain::get();
+      c.reset();
+      for (auto account : {htlc_account, "gxc.token"_n, alice, bob})
+         c.create_account(account);
+      c.set_receiver(htlc_account);
+      c.set_time(time_point_sec(1'000'000));
+      store_token(gxc_asset(0));
+   }
+
+   size_t count_contracts(name owner) {
+      gxc::htlc_contract::htlcs idx(htlc_account, owner.value);
+      return std::distance(idx.begin(), idx.end());
+   }
+
+   size_t count_expiries() {
+      gxc::htlc_contract::expiries exp(htlc_account, htlc_account.value);
+      return std::distance(exp.begin(), exp.end());
+   }
+
+}
+
+EOSIO_TEST_BEGIN(name_key_test)
+   REQUIRE_EQUAL(*gxc::htlc_contract::htlc::name_key("sendeos2bob"), "sendeos2bob"_n.value);
+   REQUIRE_EQUAL(gxc::htlc_contract::htlc::name_key("Send").has_value(), false);
+   REQUIRE_EQUAL(gxc::htlc_contract::htlc::name_key("abc.").has_value(), false);
+   REQUIRE_EQUAL(gxc::htlc_contract::htlc::name_key("a-very-long-contract-name").has_value(), false);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(sweep_test)
+   setup();
+
+   chain::get().set_auths({alice});
+   contract().newcontract(alice, "first", bob, gxc_asset(1'0000), checksum256(), time_point_sec(1'000'100));
+   contract().newcontract(alice, "a-very-long-contract-name", bob, gxc_asset(2'0000), checksum256(), time_point_sec(1'000'200));
+   REQUIRE_EQUAL(count_contracts(alice), 2u);
+
+   // not expired yet
+   chain::get().set_auths({});
+   chain::get().clear_actions();
+   contract().sweep(10);
+   REQUIRE_EQUAL(count_contracts(alice), 2u);
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 0u);
+
+   // only the earlier one is expired
+   chain::get().advance(150);
+   contract().sweep(10);
+   REQUIRE_EQUAL(count_contracts(alice), 1u);
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 1u);
+
+   chain::get().advance(100);
+   contract().sweep(10);
+   REQUIRE_EQUAL(count_contracts(alice), 0u);
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 2u);
+EOSIO_TEST_END
+
+// queue entries are keyed by their own id, and removed with the contract
+EOSIO_TEST_BEGIN(refund_dequeue_test)
+   setup();
+
+   chain::get().set_auths({alice});
+   contract().newcontract(alice, "first", bob, gxc_asset(1'0000), checksum256(), time_point_sec(1'000'100));
+   chain::get().set_auths({bob});
+   contract().newcontract(bob, "first", alice, gxc_asset(1'0000), checksum256(), time_point_sec(1'000'100));
+   REQUIRE_EQUAL(count_expiries(), 2u);
+
+   chain::get().advance(150);
+   chain::get().set_auths({alice});
+   contract().refund(alice, "first");
+   REQUIRE_EQUAL(count_contracts(alice), 0u);
+   REQUIRE_EQUAL(count_expiries(), 1u);
+EOSIO_TEST_END
+
+// refund of the head would fail in gxc.token, so it is retried later instead of blocking the queue
+EOSIO_TEST_BEGIN(sweep_unrefundable_test)
+   setup();
+   store_token(game_asset(0), 1 << gxc::token_options::paused);
+
+   chain::get().set_auths({alice});
+   contract().newcontract(alice, "first", bob, game_asset(1'0000), checksum256(), time_point_sec(1'000'100));
+   contract().newcontract(alice, "second", bob, gxc_asset(1'0000), checksum256(), time_point_sec(1'000'200));
+
+   chain::get().set_auths({});
+   chain::get().clear_actions();
+   chain::get().advance(300);
+   contract().sweep(10);
+   REQUIRE_EQUAL(count_contracts(alice), 1u);
+   REQUIRE_EQUAL(count_expiries(), 1u);
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 1u);
+
+   gxc::htlc_contract::expiries exp(htlc_account, htlc_account.value);
+   REQUIRE_EQUAL(exp.begin()->timelock, time_point_sec(1'000'300 + 24 * 3600));
+
+   // not retried until the new timelock
+   contract().sweep(10);
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 1u);
+
+   // still refundable by the owner
+   chain::get().set_auths({alice});
+   contract().refund(alice, "first");
+   REQUIRE_EQUAL(count_contracts(alice), 0u);
+   REQUIRE_EQUAL(count_expiries(), 0u);
+   REQUIRE_EQUAL(chain::get().inline_actions().size(), 2u);
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   silence_output(true);
+   MOCK_TEST(name_key_test)
+   MOCK_TEST(sweep_test)
+   MOCK_TEST(refund_dequeue_test)
+   MOCK_TEST(sweep_unrefundable_test)
+   return has_failed();
+}
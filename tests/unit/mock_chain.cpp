@@ -0,0 +1,398 @@
+#include <mock_chain.hpp>
+
+#include <eosio/tester.hpp>
+#include <eosio/transaction.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace mock {
+
+   using namespace eosio;
+
+   chain& chain::get() {
+      static chain instance;
+      return instance;
+   }
+
+   void chain::reset() {
+      _primary.clear();
+      _idx64.clear();
+      _primary_itrs.clear();
+      _idx64_itrs.clear();
+      _accounts.clear();
+      _auths.clear();
+      _receiver = name();
+      _now = 0;
+      _inlines.clear();
+      _notified.clear();
+      _deferred.clear();
+      _calls.clear();
+      _ram.clear();
+      install();
+      begin_action();
+   }
+
+   uint64_t chain::calls(const std::string& intrinsic)const {
+      auto it = _calls.find(intrinsic);
+      return it != _calls.end() ? it->second : 0;
+   }
+
+   uint64_t chain::total_calls()const {
+      uint64_t total = 0;
+      for (const auto& c : _calls) total += c.second;
+      return total;
+   }
+
+   uint64_t chain::db_calls()const {
+      uint64_t total = 0;
+      for (auto it = _calls.lower_bound("db_"); it != _calls.end() && it->first.compare(0, 3, "db_") == 0; ++it)
+         total += it->second;
+      return total;
+   }
+
+   int64_t chain::ram_usage(name payer)const {
+      auto it = _ram.find(payer.value);
+      return it != _ram.end() ? it->second : 0;
+   }
+
+   int64_t chain::total_ram_usage()const {
+      int64_t total = 0;
+      for (const auto& r : _ram) total += r.second;
+      return total;
+   }
+
+   std::vector<char> chain::row(name code, uint64_t scope, name table, uint64_t primary)const {
+      auto t = _primary.find({code.value, scope, table.value});
+      if (t == _primary.end()) return {};
+      auto r = t->second.find(primary);
+      return r != t->second.end() ? r->second.data : std::vector<char>{};
+   }
+
+   template <typename Key>
+   size_t chain::iterator_cache<Key>::table_index(const table_id& t) {
+      for (size_t i = 0; i < tables.size(); ++i) {
+         if (!(tables[i] < t) && !(t < tables[i])) return i;
+      }
+      tables.push_back(t);
+      return tables.size() - 1;
+   }
+
+   template <typename Key>
+   int32_t chain::iterator_cache<Key>::add(const table_id& t, const Key& key) {
+      rows.emplace_back(table_index(t), key);
+      return int32_t(rows.size() - 1);
+   }
+
+   const chain::table_id& chain::primary_table_of(int32_t itr)const {
+      return itr >= 0 ? _primary_itrs.tables.at(_primary_itrs.rows.at(itr).first) : _primary_itrs.table_of_end(itr);
+   }
+
+   // primary index
+
+   int32_t chain::db_store_i64(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const void* data, uint32_t len) {
+      count("db_store_i64");
+      table_id t{_receiver.value, scope, table};
+      auto& rows = _primary[t];
+      check(rows.find(id) == rows.end(), "could not insert object, most likely a uniqueness constraint was violated");
+      rows[id] = {payer, std::vector<char>((const char*)data, (const char*)data + len)};
+      _ram[payer] += primary_row_overhead + len;
+      return _primary_itrs.add(t, id);
+   }
+
+   void chain::db_update_i64(int32_t itr, uint64_t payer, const void* data, uint32_t len) {
+      count("db_update_i64");
+      const auto& [ti, id] = _primary_itrs.rows.at(itr);
+      const auto& t = _primary_itrs.tables.at(ti);
+      check(t.code == _receiver.value, "db access violation");
+      auto& r = _primary.at(t).at(id);
+      _ram[r.payer] -= primary_row_overhead + int64_t(r.data.size());
+      if (payer) r.payer = payer;
+      r.data.assign((const char*)data, (const char*)data + len);
+      _ram[r.payer] += primary_row_overhead + len;
+   }
+
+   void chain::db_remove_i64(int32_t itr) {
+      count("db_remove_i64");
+      const auto& [ti, id] = _primary_itrs.rows.at(itr);
+      const auto& t = _primary_itrs.tables.at(ti);
+      check(t.code == _receiver.value, "db access violation");
+      auto& rows = _primary.at(t);
+      const auto& r = rows.at(id);
+      _ram[r.payer] -= primary_row_overhead + int64_t(r.data.size());
+      rows.erase(id);
+   }
+
+   int32_t chain::db_get_i64(int32_t itr, void* data, uint32_t len) {
+      count("db_get_i64");
+      const auto& [ti, id] = _primary_itrs.rows.at(itr);
+      const auto& r = _primary.at(_primary_itrs.tables.at(ti)).at(id);
+      if (len == 0) return int32_t(r.data.size());
+      auto size = std::min<size_t>(len, r.data.size());
+      std::memcpy(data, r.data.data(), size);
+      return int32_t(size);
+   }
+
+   int32_t chain::db_next_i64(int32_t itr, uint64_t* primary) {
+      count("db_next_i64");
+      if (itr < -1) return -1;
+      const auto [ti, id] = _primary_itrs.rows.at(itr);
+      const auto t = _primary_itrs.tables.at(ti);
+      auto& rows = _primary.at(t);
+      auto it = rows.upper_bound(id);
+      if (it == rows.end()) return _primary_itrs.end_of(t);
+      *primary = it->first;
+      return _primary_itrs.add(t, it->first);
+   }
+
+   int32_t chain::db_previous_i64(int32_t itr, uint64_t* primary) {
+      count("db_previous_i64");
+      const auto t = primary_table_of(itr);
+      auto& rows = _primary[t];
+      auto it = (itr < -1) ? rows.end() : rows.lower_bound(_primary_itrs.rows.at(itr).second);
+      if (it == rows.begin()) return -1;
+      --it;
+      *primary = it->first;
+      return _primary_itrs.add(t, it->first);
+   }
+
+   int32_t chain::db_find_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+      count("db_find_i64");
+      table_id t{code, scope, table};
+      auto tbl = _primary.find(t);
+      if (tbl == _primary.end()) return -1;
+      if (tbl->second.find(id) == tbl->second.end()) return _primary_itrs.end_of(t);
+      return _primary_itrs.add(t, id);
+   }
+
+   int32_t chain::db_lowerbound_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+      count("db_lowerbound_i64");
+      table_id t{code, scope, table};
+      auto tbl = _primary.find(t);
+      if (tbl == _primary.end()) return -1;
+      auto it = tbl->second.lower_bound(id);
+      if (it == tbl->second.end()) return _primary_itrs.end_of(t);
+      return _primary_itrs.add(t, it->first);
+   }
+
+   int32_t chain::db_upperbound_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+      count("db_upperbound_i64");
+      table_id t{code, scope, table};
+      auto tbl = _primary.find(t);
+      if (tbl == _primary.end()) return -1;
+      auto it = tbl->second.upper_bound(id);
+      if (it == tbl->second.end()) return _primary_itrs.end_of(t);
+      return _primary_itrs.add(t, it->first);
+   }
+
+   int32_t chain::db_end_i64(uint64_t code, uint64_t scope, uint64_t table) {
+      count("db_end_i64");
+      table_id t{code, scope, table};
+      if (_primary.find(t) == _primary.end()) return -1;
+      return _primary_itrs.end_of(t);
+   }
+
+   // secondary index of uint64_t
+
+   int32_t chain::db_idx64_store(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const uint64_t* secondary) {
+      count("db_idx64_store");
+      table_id t{_receiver.value, scope, table};
+      _idx64[t][{*secondary, id}] = payer;
+      _ram[payer] += idx64_row_overhead;
+      return _idx64_itrs.add(t, {*secondary, id});
+   }
+
+   void chain::db_idx64_update(int32_t itr, uint64_t payer, const uint64_t* secondary) {
+      count("db_idx64_update");
+      const auto [ti, key] = _idx64_itrs.rows.at(itr);
+      const auto t = _idx64_itrs.tables.at(ti);
+      check(t.code == _receiver.value, "db access violation");
+      auto& idx = _idx64.at(t);
+      auto old_payer = idx.at(key);
+      idx.erase(key);
+      idx[{*secondary, key.second}] = payer ? payer : old_payer;
+      _ram[old_payer] -= idx64_row_overhead;
+      _ram[payer ? payer : old_payer] += idx64_row_overhead;
+      _idx64_itrs.rows[itr].second = {*secondary, key.second};
+   }
+
+   void chain::db_idx64_remove(int32_t itr) {
+      count("db_idx64_remove");
+      const auto& [ti, key] = _idx64_itrs.rows.at(itr);
+      const auto& t = _idx64_itrs.tables.at(ti);
+      check(t.code == _receiver.value, "db access violation");
+      auto& idx = _idx64.at(t);
+      _ram[idx.at(key)] -= idx64_row_overhead;
+      idx.erase(key);
+   }
+
+   int32_t chain::db_idx64_next(int32_t itr, uint64_t* primary) {
+      count("db_idx64_next");
+      if (itr < -1) return -1;
+      const auto [ti, key] = _idx64_itrs.rows.at(itr);
+      const auto t = _idx64_itrs.tables.at(ti);
+      auto& idx = _idx64.at(t);
+      auto it = idx.upper_bound(key);
+      if (it == idx.end()) return _idx64_itrs.end_of(t);
+      *primary = it->first.second;
+      return _idx64_itrs.add(t, it->first);
+   }
+
+   int32_t chain::db_idx64_previous(int32_t itr, uint64_t* primary) {
+      count("db_idx64_previous");
+      const auto t = itr >= 0 ? _idx64_itrs.tables.at(_idx64_itrs.rows.at(itr).first) : _idx64_itrs.table_of_end(itr);
+      auto& idx = _idx64[t];
+      auto it = (itr < -1) ? idx.end() : idx.lower_bound(_idx64_itrs.rows.at(itr).second);
+      if (it == idx.begin()) return -1;
+      --it;
+      *primary = it->first.second;
+      return _idx64_itrs.add(t, it->first);
+   }
+
+   int32_t chain::db_idx64_find_primary(uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t primary) {
+      count("db_idx64_find_primary");
+      table_id t{code, scope, table};
+      auto idx = _idx64.find(t);
+      if (idx == _idx64.end()) return -1;
+      for (const auto& e : idx->second) {
+         if (e.first.second == primary) {
+            *secondary = e.first.first;
+            return _idx64_itrs.add(t, e.first);
+         }
+      }
+      return _idx64_itrs.end_of(t);
+   }
+
+   int32_t chain::db_idx64_find_secondary(uint64_t code, uint64_t scope, uint64_t table, const uint64_t* secondary, uint64_t* primary) {
+      count("db_idx64_find_secondary");
+      table_id t{code, scope, table};
+      auto idx = _idx64.find(t);
+      if (idx == _idx64.end()) return -1;
+      auto it = idx->second.lower_bound({*secondary, 0});
+      if (it == idx->second.end() || it->first.first != *secondary) return _idx64_itrs.end_of(t);
+      *primary = it->first.second;
+      return _idx64_itrs.add(t, it->first);
+   }
+
+   int32_t chain::db_idx64_lowerbound(uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t* primary) {
+      count("db_idx64_lowerbound");
+      table_id t{code, scope, table};
+      auto idx = _idx64.find(t);
+      if (idx == _idx64.end()) return -1;
+      auto it = idx->second.lower_bound({*secondary, 0});
+      if (it == idx->second.end()) return _idx64_itrs.end_of(t);
+      *secondary = it->first.first;
+      *primary = it->first.second;
+      return _idx64_itrs.add(t, it->first);
+   }
+
+   int32_t chain::db_idx64_upperbound(uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t* primary) {
+      count("db_idx64_upperbound");
+      table_id t{code, scope, table};
+      auto idx = _idx64.find(t);
+      if (idx == _idx64.end()) return -1;
+      auto it = idx->second.upper_bound({*secondary, ~0ull});
+      if (it == idx->second.end()) return _idx64_itrs.end_of(t);
+      *secondary = it->first.first;
+      *primary = it->first.second;
+      return _idx64_itrs.add(t, it->first);
+   }
+
+   int32_t chain::db_idx64_end(uint64_t code, uint64_t scope, uint64_t table) {
+      count("db_idx64_end");
+      table_id t{code, scope, table};
+      if (_idx64.find(t) == _idx64.end()) return -1;
+      return _idx64_itrs.end_of(t);
+   }
+
+   // intrinsics
+
+   void chain::install() {
+      using namespace eosio::native;
+
+#define MOCK_DB_INTRINSIC(NAME) \
+      intrinsics::set_intrinsic<intrinsics::NAME>([](auto... args) { return chain::get().NAME(args...); });
+
+      MOCK_DB_INTRINSIC(db_store_i64)
+      MOCK_DB_INTRINSIC(db_remove_i64)
+      MOCK_DB_INTRINSIC(db_next_i64)
+      MOCK_DB_INTRINSIC(db_previous_i64)
+      MOCK_DB_INTRINSIC(db_find_i64)
+      MOCK_DB_INTRINSIC(db_lowerbound_i64)
+      MOCK_DB_INTRINSIC(db_upperbound_i64)
+      MOCK_DB_INTRINSIC(db_end_i64)
+      MOCK_DB_INTRINSIC(db_idx64_store)
+      MOCK_DB_INTRINSIC(db_idx64_update)
+      MOCK_DB_INTRINSIC(db_idx64_remove)
+      MOCK_DB_INTRINSIC(db_idx64_next)
+      MOCK_DB_INTRINSIC(db_idx64_previous)
+      MOCK_DB_INTRINSIC(db_idx64_find_primary)
+      MOCK_DB_INTRINSIC(db_idx64_find_secondary)
+      MOCK_DB_INTRINSIC(db_idx64_lowerbound)
+      MOCK_DB_INTRINSIC(db_idx64_upperbound)
+      MOCK_DB_INTRINSIC(db_idx64_end)
+
+#undef MOCK_DB_INTRINSIC
+
+      intrinsics::set_intrinsic<intrinsics::db_update_i64>([](int32_t itr, uint64_t payer, const void* data, uint32_t len) {
+         chain::get().db_update_i64(itr, payer, data, len);
+      });
+      intrinsics::set_intrinsic<intrinsics::db_get_i64>([](int32_t itr, const void* data, uint32_t len) {
+         return chain::get().db_get_i64(itr, const_cast<void*>(data), len);
+      });
+
+      intrinsics::set_intrinsic<intrinsics::has_auth>([](uint64_t account) {
+         auto& c = chain::get();
+         c.count("has_auth");
+         return std::find(c._auths.begin(), c._auths.end(), name(account)) != c._auths.end();
+      });
+      intrinsics::set_intrinsic<intrinsics::require_auth>([](uint64_t account) {
+         auto& c = chain::get();
+         c.count("require_auth");
+         check(std::find(c._auths.begin(), c._auths.end(), name(account)) != c._auths.end(),
+               "missing authority of " + name(account).to_string());
+      });
+      intrinsics::set_intrinsic<intrinsics::require_auth2>([](uint64_t account, uint64_t) {
+         auto& c = chain::get();
+         c.count("require_auth2");
+         check(std::find(c._auths.begin(), c._auths.end(), name(account)) != c._auths.end(),
+               "missing authority of " + name(account).to_string());
+      });
+      intrinsics::set_intrinsic<intrinsics::is_account>([](uint64_t account) {
+         auto& c = chain::get();
+         c.count("is_account");
+         return c._accounts.count(name(account)) > 0;
+      });
+      intrinsics::set_intrinsic<intrinsics::require_recipient>([](uint64_t account) {
+         auto& c = chain::get();
+         c.count("require_recipient");
+         c._notified.push_back(name(account));
+      });
+
+      intrinsics::set_intrinsic<intrinsics::current_receiver>([]() {
+         return chain::get()._receiver.value;
+      });
+      intrinsics::set_intrinsic<intrinsics::current_time>([]() {
+         auto& c = chain::get();
+         c.count("current_time");
+         return c._now;
+      });
+
+      intrinsics::set_intrinsic<intrinsics::send_inline>([](char* data, size_t size) {
+         auto& c = chain::get();
+         c.count("send_inline");
+         c._inlines.push_back(unpack<action>(data, size));
+      });
+      intrinsics::set_intrinsic<intrinsics::send_deferred>([](const uint128_t& sender_id, uint64_t payer, const char* data, size_t size, uint32_t) {
+         auto& c = chain::get();
+         c.count("send_deferred");
+         c._deferred[sender_id] = {name(payer), std::vector<char>(data, data + size)};
+      });
+      intrinsics::set_intrinsic<intrinsics::cancel_deferred>([](const uint128_t& sender_id) {
+         auto& c = chain::get();
+         c.count("cancel_deferred");
+         return int(c._deferred.erase(sender_id));
+      });
+   }
+
+}
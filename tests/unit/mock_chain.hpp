@@ -0,0 +1,157 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <eosio/action.hpp>
+#include <eosio/time.hpp>
+#include <gxclib/cache.hpp>
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * In-memory stand-in for the chain, replacing database, authorization, time and action intrinsics
+ * of native build of eosio.cdt.
+ *
+ * Actions are invoked by calling member functions of contract object directly, and inline actions
+ * or deferred transactions sent by them are recorded instead of being executed.
+ *
+ * Static data of contracts is not reset between calls on host, so `begin_action()` must be called before each
+ * action to invalidate action-scoped caches (e.g. `basename()`), as the `contract()` helpers of tests do.
+ */
+namespace mock {
+
+   using eosio::name;
+
+   struct deferred {
+      name              payer;
+      std::vector<char> packed_trx;
+   };
+
+   class chain {
+   public:
+      static chain& get();
+
+      // clears all states, and installs intrinsics
+      void reset();
+
+      // invalidates action-scoped caches of contracts, as static data is reset for each action on chain
+      void begin_action() { ++gxc::action_epoch; }
+
+      void create_account(name account) { _accounts.insert(account); }
+
+      // sets receiver of following actions
+      void set_receiver(name receiver) { _receiver = receiver; }
+
+      // sets authorizations of following actions
+      void set_auths(std::vector<name> auths) { _auths = std::move(auths); }
+
+      void set_time(eosio::time_point_sec t) { _now = uint64_t(t.sec_since_epoch()) * 1'000'000; }
+      void advance(uint32_t seconds) { _now += uint64_t(seconds) * 1'000'000; }
+
+      const std::vector<eosio::action>& inline_actions()const { return _inlines; }
+      const std::vector<name>& notified()const { return _notified; }
+      const std::map<uint128_t, deferred>& deferred_transactions()const { return _deferred; }
+      void clear_actions() { _inlines.clear(); _notified.clear(); }
+
+      // number of intrinsic calls by name, e.g. "db_find_i64"
+      uint64_t calls(const std::string& intrinsic)const;
+      uint64_t total_calls()const;
+      uint64_t db_calls()const; // all of db_* intrinsics
+      void reset_calls() { _calls.clear(); }
+
+      // billable RAM bytes of rows, following billable sizes of table objects in chain
+      static constexpr int64_t primary_row_overhead = 108;
+      static constexpr int64_t idx64_row_overhead   = 128;
+
+      int64_t ram_usage(name payer)const;
+      int64_t total_ram_usage()const;
+
+      // raw row of primary table, or empty if not found
+      std::vector<char> row(name code, uint64_t scope, name table, uint64_t primary)const;
+
+      // database
+
+      struct table_id {
+         uint64_t code, scope, table;
+         bool operator<(const table_id& o)const { return std::tie(code, scope, table) < std::tie(o.code, o.scope, o.table); }
+      };
+
+      struct record {
+         uint64_t          payer;
+         std::vector<char> data;
+      };
+
+      int32_t db_store_i64(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const void* data, uint32_t len);
+      void    db_update_i64(int32_t itr, uint64_t payer, const void* data, uint32_t len);
+      void    db_remove_i64(int32_t itr);
+      int32_t db_get_i64(int32_t itr, void* data, uint32_t len);
+      int32_t db_next_i64(int32_t itr, uint64_t* primary);
+      int32_t db_previous_i64(int32_t itr, uint64_t* primary);
+      int32_t db_find_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id);
+      int32_t db_lowerbound_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id);
+      int32_t db_upperbound_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id);
+      int32_t db_end_i64(uint64_t code, uint64_t scope, uint64_t table);
+
+      int32_t db_idx64_store(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const uint64_t* secondary);
+      void    db_idx64_update(int32_t itr, uint64_t payer, const uint64_t* secondary);
+      void    db_idx64_remove(int32_t itr);
+      int32_t db_idx64_next(int32_t itr, uint64_t* primary);
+      int32_t db_idx64_previous(int32_t itr, uint64_t* primary);
+      int32_t db_idx64_find_primary(uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t primary);
+      int32_t db_idx64_find_secondary(uint64_t code, uint64_t scope, uint64_t table, const uint64_t* secondary, uint64_t* primary);
+      int32_t db_idx64_lowerbound(uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t* primary);
+      int32_t db_idx64_upperbound(uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t* primary);
+      int32_t db_idx64_end(uint64_t code, uint64_t scope, uint64_t table);
+
+   private:
+      using primary_table   = std::map<uint64_t, record>;
+      using secondary_key   = std::pair<uint64_t, uint64_t>; // (secondary, primary)
+      using secondary_table = std::map<secondary_key, uint64_t>; // to payer
+
+      // iterators are indices of these vectors, and end iterator of n-th table is -(n + 2)
+      template <typename Key>
+      struct iterator_cache {
+         std::vector<table_id> tables;
+         std::vector<std::pair<size_t, Key>> rows;
+
+         size_t  table_index(const table_id& t);
+         int32_t end_of(const table_id& t) { return -int32_t(table_index(t)) - 2; }
+         int32_t add(const table_id& t, const Key& key);
+         const table_id& table_of_end(int32_t itr)const { return tables.at(size_t(-itr - 2)); }
+         void clear() { tables.clear(); rows.clear(); }
+      };
+
+      std::map<table_id, primary_table>   _primary;
+      std::map<table_id, secondary_table> _idx64;
+      iterator_cache<uint64_t>            _primary_itrs;
+      iterator_cache<secondary_key>       _idx64_itrs;
+
+      std::set<name>                      _accounts;
+      std::vector<name>                   _auths;
+      name                                _receiver;
+      uint64_t                            _now = 0;
+
+      std::vector<eosio::action>          _inlines;
+      std::vector<name>                   _notified;
+      std::map<uint128_t, deferred>       _deferred;
+
+      std::map<std::string, uint64_t>     _calls;
+      std::map<uint64_t, int64_t>         _ram;
+
+      void count(const char* intrinsic) { ++_calls[intrinsic]; }
+      void install();
+
+      const table_id& primary_table_of(int32_t itr)const;
+   };
+
+}
+
+/**
+ * Runs test case `X` of `main(argc, argv)`, unless another case is selected by the first argument.
+ * Each case is registered to ctest with its name, so it runs in its own process regardless of the order of cases.
+ */
+#define MOCK_TEST(X) \
+   if (argc < 2 || std::string(argv[1]) == #X) { EOSIO_TEST(X); }
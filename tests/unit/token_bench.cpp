@@ -0,0 +1,324 @@
+/**
+ * Throughput benchmark of gxc.token over a configurable mix of actions.
+ *
+ *    token_bench [--accounts N] [--tokens M] [--actions K] [--seed S] [--withdraw-delay SEC]
+ *                [--mix transfer=50,issue=10,recall=10,deposit=10,pushwithdraw=10,clrwithdraws=10,approve=10]
+ *
+ * Each token is minted by its own issuer, and every account starts with balance and deposit of all tokens.
+ * Actions are then replayed in random order with weights of the mix, moving the smallest unit each time.
+ * `approve` runs an approval followed by a transfer of the spender on the allowance (reported as `transfer_from`).
+ * `recall` is a transfer of the issuer from a holder's deposit, without authorization of the holder.
+ *
+ * For each action, it reports host CPU time, db_* and `is_account` intrinsic calls and RAM delta of rows in JSON
+ * on stdout.
+ * `token_bench_nocache` is the same benchmark built without the action-scoped cache of `basename`.
+ * CPU time is measured on host, so compare it between runs on the same machine rather than to WASM execution.
+ */
+#include <gxc.token/gxc.token.hpp>
+#include <mock_chain.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace eosio;
+using mock::chain;
+
+namespace {
+
+   constexpr name token_account = "gxc.token"_n;
+   constexpr name null_account  = "gxc.null"_n;
+
+   const std::vector<std::string> action_kinds = {
+      "transfer", "issue", "recall", "deposit", "pushwithdraw", "clrwithdraws", "approve"
+   };
+
+   struct config {
+      uint32_t accounts       = 100;
+      uint32_t tokens         = 4;
+      uint32_t actions        = 10000;
+      uint64_t seed           = 1;
+      uint32_t withdraw_delay = 0;
+      std::map<std::string, uint32_t> mix = {
+         {"transfer", 50}, {"issue", 10}, {"recall", 10}, {"deposit", 10}, {"pushwithdraw", 10}, {"clrwithdraws", 10},
+         {"approve", 10}
+      };
+   };
+
+   struct sample {
+      uint64_t cpu_ns;
+      uint64_t db_ops;
+      uint64_t is_account;
+      int64_t  ram_delta;
+   };
+
+   [[noreturn]] void usage(const char* msg) {
+      std::fprintf(stderr, "token_bench: %s\n", msg);
+      std::exit(2);
+   }
+
+   void parse_mix(const std::string& spec, std::map<std::string, uint32_t>& mix) {
+      mix.clear();
+      size_t pos = 0;
+      while (pos < spec.size()) {
+         auto end = std::min(spec.find(',', pos), spec.size());
+         auto item = spec.substr(pos, end - pos);
+         auto eq = item.find('=');
+         if (eq == std::string::npos) usage("mix should be a list of `action=weight`");
+
+         auto kind = item.substr(0, eq);
+         if (std::find(action_kinds.begin(), action_kinds.end(), kind) == action_kinds.end())
+            usage(("unknown action `" + kind + "` in mix").c_str());
+         mix[kind] = static_cast<uint32_t>(std::stoul(item.substr(eq + 1)));
+         pos = end + 1;
+      }
+   }
+
+   config parse_args(int argc, char** argv) {
+      config cfg;
+      for (int i = 1; i < argc; ++i) {
+         std::string arg = argv[i];
+         if (i + 1 >= argc) usage(("missing value of " + arg).c_str());
+         std::string value = argv[++i];
+
+         if (arg == "--accounts")            cfg.accounts = std::stoul(value);
+         else if (arg == "--tokens")         cfg.tokens = std::stoul(value);
+         else if (arg == "--actions")        cfg.actions = std::stoul(value);
+         else if (arg == "--seed")           cfg.seed = std::stoull(value);
+         else if (arg == "--withdraw-delay") cfg.withdraw_delay = std::stoul(value);
+         else if (arg == "--mix")            parse_mix(value, cfg.mix);
+         else usage(("unknown argument " + arg).c_str());
+      }
+
+      if (cfg.accounts < 2) usage("at least 2 accounts are required");
+      if (cfg.tokens < 1 || cfg.tokens > 26 * 26) usage("tokens should be in [1, 676]");
+      if (cfg.mix["clrwithdraws"] && !cfg.mix["pushwithdraw"]) usage("clrwithdraws requires pushwithdraw in mix");
+
+      uint32_t total = 0;
+      for (const auto& m : cfg.mix) total += m.second;
+      if (!total) usage("empty mix");
+      return cfg;
+   }
+
+   // `prefix` followed by `i` in letters, e.g. user.aaab
+   name numbered(const std::string& prefix, uint32_t i, int digits) {
+      std::string s = prefix;
+      for (int d = digits - 1; d >= 0; --d) {
+         uint32_t div = 1;
+         for (int k = 0; k < d; ++k) div *= 26;
+         s += char('a' + (i / div) % 26);
+      }
+      return name(s);
+   }
+
+   std::vector<int8_t> packed(uint64_t value) {
+      auto data = pack(value);
+      return std::vector<int8_t>(data.begin(), data.end());
+   }
+
+   gxc::token_contract contract() {
+      chain::get().begin_action();
+      return gxc::token_contract(token_account, token_account, datastream<const char*>(nullptr, 0));
+   }
+
+   void install_assert() {
+      using namespace eosio::native;
+      intrinsics::set_intrinsic<intrinsics::eosio_assert>([](uint32_t test, const char* msg) {
+         if (!test) throw std::runtime_error(msg);
+      });
+      intrinsics::set_intrinsic<intrinsics::eosio_assert_message>([](uint32_t test, const char* msg, uint32_t len) {
+         if (!test) throw std::runtime_error(std::string(msg, len));
+      });
+      intrinsics::set_intrinsic<intrinsics::eosio_assert_code>([](uint32_t test, uint64_t code) {
+         if (!test) throw std::runtime_error("assertion failure with error code " + std::to_string(code));
+      });
+   }
+
+   class bench {
+   public:
+      explicit bench(const config& cfg) : _cfg(cfg), _rng(cfg.seed) {
+         for (uint32_t i = 0; i < cfg.accounts; ++i) _accounts.push_back(numbered("user.", i, 4));
+         for (uint32_t i = 0; i < cfg.tokens; ++i) {
+            _issuers.push_back(numbered("issuer.", i, 2));
+            _symbols.push_back(symbol(symbol_code(std::string("TK") + char('A' + i / 26) + char('A' + i % 26)), 4));
+         }
+      }
+
+      void setup() {
+         auto& c = chain::get();
+         c.reset();
+         install_assert();
+         c.set_time(time_point_sec(1'500'000'000));
+         c.set_receiver(token_account);
+
+         for (auto account : {token_account, null_account, "gxc"_n}) c.create_account(account);
+         for (auto account : _accounts) c.create_account(account);
+         for (auto account : _issuers) c.create_account(account);
+
+         const int64_t initial = 1'000'000'0000;
+         const int64_t supply = initial * 2 * (_cfg.accounts + 1);
+
+         for (uint32_t t = 0; t < _cfg.tokens; ++t) {
+            c.set_auths({token_account});
+            contract().mint(value_of(t, supply), {{"withdraw_delay_sec", packed(_cfg.withdraw_delay)}});
+
+            c.set_auths({_issuers[t]});
+            contract().transfer(null_account, _issuers[t], value_of(t, initial * (_cfg.accounts + 1)), "");
+            for (auto account : _accounts) {
+               contract().transfer(_issuers[t], account, value_of(t, initial), "");
+               contract().transfer(null_account, account, value_of(t, initial), "");
+            }
+         }
+         c.clear_actions();
+      }
+
+      void run() {
+         std::vector<std::string> kinds;
+         std::vector<uint32_t> weights;
+         for (const auto& m : _cfg.mix) {
+            kinds.push_back(m.first);
+            weights.push_back(m.second);
+         }
+         std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+         for (uint32_t done = 0; done < _cfg.actions; ) {
+            const auto& kind = kinds[pick(_rng)];
+            if (kind == "clrwithdraws" && _pending.empty()) continue;
+            replay(kind);
+            ++done;
+         }
+      }
+
+      void report()const {
+         std::printf("{\n  \"config\": {\"accounts\": %u, \"tokens\": %u, \"actions\": %u, \"seed\": %llu, \"withdraw_delay\": %u, \"mix\": {",
+                     _cfg.accounts, _cfg.tokens, _cfg.actions, (unsigned long long)_cfg.seed, _cfg.withdraw_delay);
+         const char* sep = "";
+         for (const auto& m : _cfg.mix) {
+            std::printf("%s\"%s\": %u", sep, m.first.c_str(), m.second);
+            sep = ", ";
+         }
+         std::printf("}},\n  \"actions\": {");
+
+         sep = "\n";
+         for (const auto& r : _samples) {
+            auto samples = r.second;
+            std::sort(samples.begin(), samples.end(), [](const auto& a, const auto& b) { return a.cpu_ns < b.cpu_ns; });
+
+            uint64_t cpu = 0, db = 0, accounts = 0;
+            int64_t ram = 0;
+            for (const auto& s : samples) {
+               cpu      += s.cpu_ns;
+               db       += s.db_ops;
+               accounts += s.is_account;
+               ram      += s.ram_delta;
+            }
+            double n = double(samples.size());
+
+            std::printf("%s    \"%s\": {\"count\": %zu, \"cpu_ns_avg\": %.1f, \"cpu_ns_p50\": %llu, \"cpu_ns_p99\": %llu, "
+                        "\"db_ops_avg\": %.2f, \"is_account_avg\": %.2f, \"ram_delta_avg\": %.1f, \"ram_delta_total\": %lld}",
+                        sep, r.first.c_str(), samples.size(), cpu / n,
+                        (unsigned long long)samples[samples.size() / 2].cpu_ns,
+                        (unsigned long long)samples[samples.size() * 99 / 100].cpu_ns,
+                        db / n, accounts / n, ram / n, (long long)ram);
+            sep = ",\n";
+         }
+         std::printf("\n  },\n  \"ram_total\": %lld\n}\n", (long long)chain::get().total_ram_usage());
+      }
+
+   private:
+      const config&                             _cfg;
+      std::mt19937_64                           _rng;
+      std::vector<name>                         _accounts;
+      std::vector<name>                         _issuers;
+      std::vector<symbol>                       _symbols;
+      std::vector<name>                         _pending; // owners with withdrawal requests
+      std::set<name>                            _pending_set;
+      std::map<std::string, std::vector<sample>> _samples;
+
+      extended_asset value_of(uint32_t t, int64_t amount)const {
+         return extended_asset(asset(amount, _symbols[t]), _issuers[t]);
+      }
+
+      uint32_t random(uint32_t n) { return std::uniform_int_distribution<uint32_t>(0, n - 1)(_rng); }
+
+      name random_account() { return _accounts[random(_accounts.size())]; }
+
+      template <typename Action>
+      void measure(const std::string& kind, std::vector<name> auths, Action&& act) {
+         auto& c = chain::get();
+         c.set_auths(std::move(auths));
+         c.reset_calls();
+         auto ram = c.total_ram_usage();
+
+         auto start = std::chrono::steady_clock::now();
+         try {
+            act();
+         } catch (const std::exception& e) {
+            std::fprintf(stderr, "token_bench: %s failed: %s\n", kind.c_str(), e.what());
+            std::exit(1);
+         }
+         auto elapsed = std::chrono::steady_clock::now() - start;
+
+         _samples[kind].push_back({
+            uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+            c.db_calls(),
+            c.calls("is_account"),
+            c.total_ram_usage() - ram
+         });
+         c.clear_actions();
+      }
+
+      void replay(const std::string& kind) {
+         auto t = random(_cfg.tokens);
+         auto one = value_of(t, 1);
+         auto owner = random_account();
+
+         if (kind == "transfer") {
+            auto to = random_account();
+            while (to == owner) to = random_account();
+            measure(kind, {owner}, [&]() { contract().transfer(owner, to, one, "bench"); });
+         } else if (kind == "issue") {
+            measure(kind, {_issuers[t]}, [&]() { contract().transfer(null_account, owner, one, "bench"); });
+         } else if (kind == "recall") {
+            measure(kind, {_issuers[t]}, [&]() { contract().transfer(owner, _issuers[t], one, "bench"); });
+         } else if (kind == "deposit") {
+            measure(kind, {owner}, [&]() { contract().deposit(owner, one); });
+         } else if (kind == "pushwithdraw") {
+            measure(kind, {owner}, [&]() { contract().pushwithdraw(owner, one); });
+            if (_pending_set.insert(owner).second) _pending.push_back(owner);
+         } else if (kind == "clrwithdraws") {
+            auto i = random(_pending.size());
+            owner = _pending[i];
+            std::swap(_pending[i], _pending.back());
+            _pending.pop_back();
+            _pending_set.erase(owner);
+
+            chain::get().advance(_cfg.withdraw_delay);
+            measure(kind, {owner}, [&]() { contract().clrwithdraws(owner); });
+         } else if (kind == "approve") {
+            auto spender = random_account();
+            while (spender == owner) spender = random_account();
+            measure(kind, {owner}, [&]() { contract().approve(owner, spender, one); });
+            measure("transfer_from", {spender}, [&]() { contract().transfer(owner, spender, one, "bench"); });
+         }
+      }
+   };
+
+}
+
+int main(int argc, char** argv) {
+   auto cfg = parse_args(argc, argv);
+
+   bench b(cfg);
+   b.setup();
+   b.run();
+   b.report();
+   return 0;
+}
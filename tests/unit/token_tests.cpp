@@ -0,0 +1,511 @@
+#include <gxc.token/gxc.token.hpp>
+#include <gxclib/token_reader.hpp>
+#include <mock_chain.hpp>
+
+#include <eosio/tester.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+#include <new>
+
+using namespace eosio;
+using mock::chain;
+
+namespace {
+   uint64_t allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+   ++allocations;
+   if (void* p = std::malloc(size ? size : 1)) return p;
+   throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+   constexpr name token_account = "gxc.token"_n;
+   constexpr name null_account  = "gxc.null"_n;
+   constexpr name issuer        = "game"_n;
+   constexpr name alice         = "alice"_n;
+   constexpr name bob           = "bob"_n;
+
+   const symbol game_symbol = symbol("GAME", 4);
+
+   extended_asset game(int64_t amount) { return extended_asset(asset(amount, game_symbol), issuer); }
+
+   gxc::token_contract contract() {
+      chain::get().begin_action();
+      return gxc::token_contract(token_account, token_account, datastream<const char*>(nullptr, 0));
+   }
+
+   asset balance_of(name owner) {
+      return gxc::token_reader::account(owner, issuer, game_symbol.code()).balance();
+   }
+
+   // heap allocations of `f(i)`, the minimum of a few runs not to count growth of containers in mock chain
+   template <typename F>
+   uint64_t allocations_of(F&& f) {
+      uint64_t min = UINT64_MAX;
+      for (int i = 0; i < 3; ++i) {
+         auto before = allocations;
+         f(i);
+         min = std::min(min, allocations - before);
+      }
+      return min;
+   }
+
+   // mints GAME with recallable option off, and issues `amount` to the issuer
+   void setup(int64_t amount) {
+      auto& c = chain::get();
+      c.reset();
+      for (auto account : {token_account, null_account, issuer, alice, bob})
+         c.create_account(account);
+      c.set_receiver(token_account);
+
+      c.set_auths({token_account});
+      contract().mint(game(amount), {{"recallable", {0}}});
+
+      c.set_auths({issuer});
+      contract().transfer(null_account, issuer, game(amount), "");
+   }
+
+}
+
+EOSIO_TEST_BEGIN(issue_and_transfer_test)
+   setup(1000'0000);
+   REQUIRE_EQUAL(balance_of(issuer), asset(1000'0000, game_symbol));
+   REQUIRE_EQUAL(gxc::token_reader::stat(issuer, game_symbol.code()).supply(), asset(1000'0000, game_symbol));
+
+   contract().transfer(issuer, alice, game(10'0000), "");
+   REQUIRE_EQUAL(balance_of(issuer), asset(990'0000, game_symbol));
+   REQUIRE_EQUAL(balance_of(alice), asset(10'0000, game_symbol));
+
+   // transfer without authorization of sender
+   CHECK_ASSERT("Missing required authority", []() {
+      contract().transfer(alice, bob, game(1'0000), "");
+   });
+
+   chain::get().set_auths({alice});
+   contract().transfer(alice, bob, game(1'0000), "");
+   REQUIRE_EQUAL(balance_of(bob), asset(1'0000, game_symbol));
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(settle_test)
+   setup(1000'0000);
+
+   constexpr name settler = "gxc.bancor"_n;
+   chain::get().create_account(settler);
+
+   // only system contracts settle
+   chain::get().set_auths({issuer, alice});
+   CHECK_ASSERT("settle is only allowed to system contracts", []() {
+      contract().settle(alice, {{issuer, alice, game(10'0000), ""}});
+   });
+
+   chain::get().set_auths({settler, issuer, alice});
+   contract().settle(settler, {
+      {issuer, alice, game(10'0000), "first"},
+      {alice, bob, game(3'0000), "second"},
+      {issuer, null_account, game(5'0000), "retire"}
+   });
+
+   REQUIRE_EQUAL(balance_of(issuer), asset(985'0000, game_symbol));
+   REQUIRE_EQUAL(balance_of(alice), asset(7'0000, game_symbol));
+   REQUIRE_EQUAL(balance_of(bob), asset(3'0000, game_symbol));
+   REQUIRE_EQUAL(gxc::token_reader::stat(issuer, game_symbol.code()).supply(), asset(995'0000, game_symbol));
+EOSIO_TEST_END
+
+// credits to the same recipient are merged, and the sender is debited the total at once
+EOSIO_TEST_BEGIN(transfer_batch_test)
+   setup(1000'0000);
+   contract().transfer(issuer, alice, game(10'0000), "");
+   contract().transfer(issuer, bob, game(1'0000), "");
+
+   auto& c = chain::get();
+   c.set_auths({alice});
+   c.reset_calls();
+   contract().transferbatch(alice, {
+      {bob, game(3'0000), "first"},
+      {issuer, game(2'0000), "second"},
+      {bob, game(1'0000), "third"}
+   });
+
+   REQUIRE_EQUAL(balance_of(alice), asset(4'0000, game_symbol));
+   REQUIRE_EQUAL(balance_of(bob), asset(5'0000, game_symbol));
+   REQUIRE_EQUAL(balance_of(issuer), asset(991'0000, game_symbol));
+   REQUIRE_EQUAL(c.calls("db_update_i64"), 3u); // alice, bob once, issuer
+
+   // each leg is covered by the balance, but the total is not
+   CHECK_ASSERT("overdrawn balance", []() {
+      contract().transferbatch(alice, {{bob, game(3'0000), ""}, {issuer, game(3'0000), ""}});
+   });
+   REQUIRE_EQUAL(balance_of(alice), asset(4'0000, game_symbol));
+
+   CHECK_ASSERT("`to` account does not exist", []() {
+      contract().transferbatch(alice, {{bob, game(1'0000), ""}, {"nobody"_n, game(1'0000), ""}});
+   });
+EOSIO_TEST_END
+
+// each intrinsic and table lookup runs once per transfer
+EOSIO_TEST_BEGIN(transfer_intrinsics_test)
+   setup(1000'0000);
+   contract().transfer(issuer, alice, game(10'0000), "");
+   contract().transfer(issuer, bob, game(10'0000), "");
+
+   auto& c = chain::get();
+   c.set_auths({alice});
+   c.reset_calls();
+   contract().transfer(alice, bob, game(1'0000), "");
+
+   REQUIRE_EQUAL(c.calls("is_account"), 1u);
+   REQUIRE_EQUAL(c.calls("has_auth"), 2u);    // alice as sender, bob as payer
+   REQUIRE_EQUAL(c.calls("db_find_i64"), 3u); // stat, alice, bob
+   REQUIRE_EQUAL(c.calls("db_update_i64"), 2u);
+   REQUIRE_EQUAL(c.calls("db_store_i64") + c.calls("db_remove_i64"), 0u);
+
+   // retire does not look up recipient
+   c.reset_calls();
+   contract().transfer(alice, null_account, game(1'0000), "");
+
+   REQUIRE_EQUAL(c.calls("is_account"), 0u);
+   REQUIRE_EQUAL(c.calls("has_auth"), 1u);
+   REQUIRE_EQUAL(c.calls("db_find_i64"), 2u); // stat, alice
+   REQUIRE_EQUAL(balance_of(alice), asset(8'0000, game_symbol));
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(allowance_test)
+   setup(1000'0000);
+   contract().transfer(issuer, alice, game(10'0000), "");
+   contract().transfer(issuer, bob, game(10'0000), "");
+
+   auto& c = chain::get();
+   c.set_auths({alice});
+   contract().approve(alice, bob, game(5'0000));
+
+   // spent by bob, with a single lookup of allowance
+   c.set_auths({bob});
+   c.reset_calls();
+   contract().transfer(alice, bob, game(2'0000), "");
+   REQUIRE_EQUAL(c.calls("db_find_i64"), 4u); // stat, allowance, alice, bob
+   REQUIRE_EQUAL(balance_of(bob), asset(12'0000, game_symbol));
+
+   gxc::token_contract::allowed _allowed(token_account, alice.value);
+   auto _idx = _allowed.get_index<"byspender"_n>();
+   auto it = _idx.find(bob.value);
+   REQUIRE_EQUAL(it != _idx.end(), true);
+   REQUIRE_EQUAL(it->quantity, asset(3'0000, game_symbol));
+
+   CHECK_ASSERT("try transfering more than allowed", []() {
+      contract().transfer(alice, bob, game(4'0000), "");
+   });
+   CHECK_ASSERT("Missing required authority", []() {
+      contract().transfer(issuer, bob, game(1'0000), "");
+   });
+
+   // spending all of allowance erases it with its index entry
+   contract().transfer(alice, bob, game(3'0000), "");
+   gxc::token_contract::allowed _after(token_account, alice.value);
+   REQUIRE_EQUAL(_after.begin() == _after.end(), true);
+   auto _after_idx = _after.get_index<"byspender"_n>();
+   REQUIRE_EQUAL(_after_idx.begin() == _after_idx.end(), true);
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(allowance_expiry_test)
+   setup(1000'0000);
+   contract().transfer(issuer, alice, game(10'0000), "");
+
+   auto& c = chain::get();
+   c.set_time(time_point_sec(1'500'000'000));
+   c.set_auths({alice});
+
+   auto count_allowances = []() {
+      gxc::token_contract::allowed _allowed(token_account, alice.value);
+      return std::distance(_allowed.begin(), _allowed.end());
+   };
+
+   CHECK_ASSERT("expiration should be in the future", []() {
+      contract().approve(alice, bob, game(1'0000), time_point_sec(1'500'000'000));
+   });
+
+   contract().approve(alice, bob, game(5'0000), time_point_sec(1'500'000'060));
+   contract().approve(alice, issuer, game(5'0000), time_point_sec(1'500'000'060));
+   REQUIRE_EQUAL(count_allowances(), 2);
+
+   c.advance(60);
+   c.set_auths({bob});
+   CHECK_ASSERT("allowance expired", []() {
+      contract().transfer(alice, bob, game(1'0000), "");
+   });
+
+   // expired allowances are pruned by approve of the owner
+   c.set_auths({alice});
+   contract().approve(alice, bob, game(1'0000), time_point_sec(1'500'000'120));
+   REQUIRE_EQUAL(count_allowances(), 1);
+
+   // allowances without expiration, then revoked at once
+   contract().approve(alice, issuer, game(1'0000));
+   REQUIRE_EQUAL(count_allowances(), 2);
+
+   contract().revokeall(alice, bob);
+   REQUIRE_EQUAL(count_allowances(), 1);
+   contract().revokeall(alice, std::nullopt);
+   REQUIRE_EQUAL(count_allowances(), 0);
+
+   CHECK_ASSERT("allowance not found", []() {
+      contract().revokeall(alice, std::nullopt);
+   });
+EOSIO_TEST_END
+
+// rows approved before secondary indices were added are approved and revoked as indexed rows
+EOSIO_TEST_BEGIN(allowance_legacy_test)
+   setup(1000'0000);
+   contract().transfer(issuer, alice, game(10'0000), "");
+
+   auto& c = chain::get();
+   c.set_time(time_point_sec(1'500'000'000));
+   c.set_auths({alice});
+
+   auto count_allowances = []() {
+      gxc::token_contract::allowed _allowed(token_account, alice.value);
+      return std::distance(_allowed.begin(), _allowed.end());
+   };
+   auto count_by_spender = [](name spender) {
+      gxc::token_contract::allowed _allowed(token_account, alice.value);
+      auto _idx = _allowed.get_index<"byspender"_n>();
+      return std::distance(_idx.lower_bound(spender.value), _idx.upper_bound(spender.value));
+   };
+
+   // rows without secondary entries, as written by the previous contract
+   auto store_legacy = [](name spender, int64_t amount) {
+      auto value = game(amount);
+      auto data  = pack(gxc::token_contract::allowance{spender, value.quantity, value.contract});
+      internal_use_do_not_use::db_store_i64(alice.value, "allowance"_n.value, alice.value,
+         gxc::token_contract::allowance::get_approval_id(spender, value), data.data(), data.size());
+   };
+   store_legacy(bob, 1'0000);
+   store_legacy(issuer, 1'0000);
+   REQUIRE_EQUAL(count_allowances(), 2);
+   REQUIRE_EQUAL(count_by_spender(bob), 0);
+
+   // changing expiration stores the row with its secondary entries
+   contract().approve(alice, issuer, game(2'0000), time_point_sec(1'500'000'060));
+   REQUIRE_EQUAL(count_by_spender(issuer), 1);
+
+   contract().revokeall(alice, bob);
+   REQUIRE_EQUAL(count_allowances(), 1);
+   contract().revokeall(alice, issuer);
+   REQUIRE_EQUAL(count_allowances(), 0);
+EOSIO_TEST_END
+
+// aggregates of `statext` follow holders, deposits and withdrawal requests
+EOSIO_TEST_BEGIN(stat_ext_test)
+   setup(1000'0000);
+   auto& c = chain::get();
+   auto ext = []() { return gxc::token_reader::stat_ext(issuer, game_symbol.code()); };
+
+   REQUIRE_EQUAL(ext().holders(), 1);
+
+   contract().transfer(issuer, alice, game(10'0000), "");
+   REQUIRE_EQUAL(ext().holders(), 2);
+
+   c.set_auths({alice});
+   contract().transfer(alice, bob, game(10'0000), "");
+   REQUIRE_EQUAL(ext().holders(), 2);
+
+   c.set_auths({issuer});
+   contract().setacntopts(bob, issuer, game_symbol.code(), {{"frozen", {1}}});
+   REQUIRE_EQUAL(ext().frozen(), 1);
+   contract().setacntopts(bob, issuer, game_symbol.code(), {{"frozen", {0}}});
+   REQUIRE_EQUAL(ext().frozen(), 0);
+
+   // recallable token, issued to deposit
+   const symbol gem_symbol = symbol("GEM", 4);
+   auto gem = [&](int64_t amount) { return extended_asset(asset(amount, gem_symbol), issuer); };
+   auto gem_ext = [&]() { return gxc::token_reader::stat_ext(issuer, gem_symbol.code()); };
+
+   c.set_auths({token_account});
+   contract().mint(gem(1000'0000), {{"withdraw_min_amount", {1, 0, 0, 0, 0, 0, 0, 0}}});
+   c.set_auths({issuer});
+   contract().transfer(null_account, alice, gem(10'0000), "");
+   REQUIRE_EQUAL(gem_ext().holders(), 1);
+   REQUIRE_EQUAL(gem_ext().deposit(), asset(10'0000, gem_symbol));
+
+   c.set_auths({alice});
+   contract().pushwithdraw(alice, gem(4'0000));
+   REQUIRE_EQUAL(gem_ext().holders(), 1);
+   REQUIRE_EQUAL(gem_ext().deposit(), asset(6'0000, gem_symbol));
+   REQUIRE_EQUAL(gem_ext().withdrawing(), asset(4'0000, gem_symbol));
+
+   contract().popwithdraw(alice, issuer, gem_symbol.code());
+   REQUIRE_EQUAL(gem_ext().deposit(), asset(10'0000, gem_symbol));
+   REQUIRE_EQUAL(gem_ext().withdrawing(), asset(0, gem_symbol));
+
+   // tokens minted before the table are counted once seeded
+   c.set_auths({token_account});
+   gxc::token_contract::statext _exts(token_account, issuer.value);
+   _exts.erase(_exts.find(game_symbol.code().raw()));
+   REQUIRE_EQUAL(ext().exists(), false);
+
+   c.set_auths({bob});
+   contract().transfer(bob, issuer, game(10'0000), "");
+   REQUIRE_EQUAL(ext().exists(), false);
+
+   CHECK_ASSERT("missing authority of gxc.token", []() {
+      contract().setstatext(issuer, game_symbol.code(), 3, 0, 0);
+   });
+   c.set_auths({token_account});
+   contract().setstatext(issuer, game_symbol.code(), 3, 0, 0);
+   REQUIRE_EQUAL(ext().holders(), 3);
+
+   // seeded only once
+   CHECK_ASSERT("statext already seeded", []() {
+      contract().setstatext(issuer, game_symbol.code(), 4, 0, 0);
+   });
+EOSIO_TEST_END
+
+// seeding fails on a token which has a row already, and a seeded token keeps being counted by actions
+EOSIO_TEST_BEGIN(stat_ext_seed_test)
+   setup(1000'0000);
+   auto& c = chain::get();
+   auto ext = []() { return gxc::token_reader::stat_ext(issuer, game_symbol.code()); };
+
+   contract().transfer(issuer, alice, game(10'0000), "");
+   contract().transfer(issuer, bob, game(10'0000), "");
+   REQUIRE_EQUAL(ext().holders(), 3);
+
+   // minted after the table, so the row is created by mint
+   c.set_auths({token_account});
+   CHECK_ASSERT("statext already seeded", []() {
+      contract().setstatext(issuer, game_symbol.code(), 5, 0, 0);
+   });
+   REQUIRE_EQUAL(ext().holders(), 3);
+
+   // a token minted before the table, which has holders but no row
+   gxc::token_contract::statext _exts(token_account, issuer.value);
+   _exts.erase(_exts.find(game_symbol.code().raw()));
+
+   CHECK_ASSERT("must not be negative", []() {
+      contract().setstatext(issuer, game_symbol.code(), -1, 0, 0);
+   });
+   contract().setstatext(issuer, game_symbol.code(), 3, 0, 0);
+   REQUIRE_EQUAL(ext().holders(), 3);
+   REQUIRE_EQUAL(ext().deposit(), asset(0, game_symbol));
+
+   // closing alice's balance is counted from the seeded values
+   c.set_auths({alice});
+   contract().transfer(alice, bob, game(10'0000), "");
+   REQUIRE_EQUAL(ext().holders(), 2);
+EOSIO_TEST_END
+
+// deferred `clrwithdraws` and its schedule are charged to the owner only when the owner authorizes
+EOSIO_TEST_BEGIN(withdraw_schedule_payer_test)
+   setup(1000'0000);
+   auto& c = chain::get();
+   c.set_time(time_point_sec(1'000'000));
+
+   const symbol gem_symbol = symbol("GEM", 4);
+   const symbol ore_symbol = symbol("ORE", 4);
+   auto gem = [&](int64_t amount) { return extended_asset(asset(amount, gem_symbol), issuer); };
+   auto ore = [&](int64_t amount) { return extended_asset(asset(amount, ore_symbol), issuer); };
+
+   c.set_auths({token_account});
+   contract().mint(gem(1000'0000), {{"withdraw_min_amount", {1, 0, 0, 0, 0, 0, 0, 0}}});
+   contract().mint(ore(1000'0000), {{"withdraw_min_amount", {1, 0, 0, 0, 0, 0, 0, 0}}});
+   c.set_auths({issuer});
+   contract().transfer(null_account, alice, gem(10'0000), "");
+   contract().transfer(null_account, alice, ore(10'0000), "");
+
+   c.set_auths({alice});
+   contract().pushwithdraw(alice, gem(10'0000));
+   c.advance(100);
+   contract().pushwithdraw(alice, ore(10'0000));
+   REQUIRE_EQUAL(c.deferred_transactions().at(alice.value).payer, alice);
+
+   // wake-up for GEM has passed without `clrwithdraws`, and recall of GEM reschedules it for ORE
+   c.advance(24 * 3600 - 50);
+   c.set_auths({issuer});
+   contract().transfer(alice, issuer, gem(10'0000), "");
+   REQUIRE_EQUAL(c.deferred_transactions().at(alice.value).payer, token_account);
+
+   gxc::token_contract::schedule _sched(token_account, alice.value);
+   REQUIRE_EQUAL(_sched.get().scheduled_time, time_point_sec(1'000'100 + 24 * 3600));
+EOSIO_TEST_END
+
+// the number of options does not change heap allocations of mint and setopts
+EOSIO_TEST_BEGIN(options_allocation_test)
+   setup(1000'0000);
+   auto& c = chain::get();
+
+   using opts_type = std::vector<gxc::token_contract::key_value>;
+
+   // options are passed by value to actions, so copies are made before counting
+   auto copies = [](const opts_type& opts) { return std::vector<opts_type>(3, opts); };
+
+   auto one  = copies({{"recallable", {0}}});
+   auto four = copies({{"recallable", {0}}, {"freezable", {0}}, {"pausable", {1}}, {"whitelistable", {1}}});
+   const char* symbols[] = {"AAA", "AAB", "AAC", "BBA", "BBB", "BBC"};
+
+   c.set_auths({token_account});
+   auto mint_one = allocations_of([&](int i) {
+      contract().mint(extended_asset(asset(1000, symbol(symbols[i], 0)), issuer), std::move(one[i]));
+   });
+   auto mint_four = allocations_of([&](int i) {
+      contract().mint(extended_asset(asset(1000, symbol(symbols[i + 3], 0)), issuer), std::move(four[i]));
+   });
+   REQUIRE_EQUAL(mint_one, mint_four);
+
+   auto paused_one  = copies(opts_type(1, {"paused", {0}}));
+   auto paused_four = copies(opts_type(4, {"paused", {0}}));
+
+   c.set_auths({issuer});
+   auto setopts_one = allocations_of([&](int i) {
+      contract().setopts(issuer, game_symbol.code(), std::move(paused_one[i]));
+   });
+   auto setopts_four = allocations_of([&](int i) {
+      contract().setopts(issuer, game_symbol.code(), std::move(paused_four[i]));
+   });
+   REQUIRE_EQUAL(setopts_one, setopts_four);
+EOSIO_TEST_END
+
+// authority is checked before options are decoded, and a repeated option is applied in order
+EOSIO_TEST_BEGIN(account_options_test)
+   setup(1000'0000);
+   auto& c = chain::get();
+   contract().transfer(issuer, alice, game(10'0000), "");
+
+   c.set_auths({alice});
+   CHECK_ASSERT("missing authority of game", []() {
+      contract().setacntopts(alice, issuer, game_symbol.code(), {{"unknown", {1}}});
+   });
+   CHECK_ASSERT("missing authority of game", []() {
+      contract().setacntsopts({alice}, issuer, game_symbol.code(), {{"unknown", {1}}});
+   });
+
+   c.set_auths({issuer});
+   CHECK_ASSERT("option already has give value", []() {
+      contract().setacntopts(alice, issuer, game_symbol.code(), {{"frozen", {1}}, {"frozen", {1}}});
+   });
+
+   contract().setacntopts(alice, issuer, game_symbol.code(), {{"frozen", {1}}, {"frozen", {0}}, {"frozen", {1}}});
+   REQUIRE_EQUAL(gxc::token_reader::account(alice, issuer, game_symbol.code()).option(0), true);
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   silence_output(true);
+   MOCK_TEST(issue_and_transfer_test)
+   MOCK_TEST(settle_test)
+   MOCK_TEST(transfer_batch_test)
+   MOCK_TEST(transfer_intrinsics_test)
+   MOCK_TEST(allowance_test)
+   MOCK_TEST(allowance_expiry_test)
+   MOCK_TEST(allowance_legacy_test)
+   MOCK_TEST(stat_ext_test)
+   MOCK_TEST(stat_ext_seed_test)
+   MOCK_TEST(withdraw_schedule_payer_test)
+   MOCK_TEST(options_allocation_test)
+   MOCK_TEST(account_options_test)
+   return has_failed();
+}